@@ -10,8 +10,9 @@ DEFINE_LOG_CATEGORY(LogStaticTicker);
 UStaticTickerManager::UStaticTickerManager()
 {
 	GameStartedDelegateHandle = FZeonUtil::OnWorldBeginPlay.AddUObject(this, &UStaticTickerManager::OnGameStarted);
-	GameEndedDelegateHandle = FWorldDelegates::OnWorldBeginTearDown.AddUObject(this, &UStaticTickerManager::OnGameEnded);
+	GameEndedDelegateHandle = FZeonUtil::OnWorldBeginTearDown.AddUObject(this, &UStaticTickerManager::OnGameEnded);
 	GamePauseDelegateHandle = FPauseManager::OnGamePause.AddUObject(this, &UStaticTickerManager::OnGamePaused);
+	PauseScopeDelegateHandle = FPauseManager::OnPauseScopeChanged.AddUObject(this, &UStaticTickerManager::OnPauseScopeChanged);
 	TryAutoModifyTickerState(ETickerStateType::Init);
 }
 
@@ -22,8 +23,9 @@ void UStaticTickerManager::BeginDestroy()
 	TickerModules.Empty();
 	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
 	FZeonUtil::OnWorldBeginPlay.Remove(GameStartedDelegateHandle);
-	FWorldDelegates::OnWorldBeginTearDown.Remove(GameEndedDelegateHandle);
+	FZeonUtil::OnWorldBeginTearDown.Remove(GameEndedDelegateHandle);
 	FPauseManager::OnGamePause.Remove(GamePauseDelegateHandle);
+	FPauseManager::OnPauseScopeChanged.Remove(PauseScopeDelegateHandle);
 }
 
 
@@ -31,7 +33,7 @@ bool UStaticTickerManager::Tick(float DeltaTime)
 {
 	for (auto [_, Module] : TickerModules)
 	{
-		if (Module->bTickInPauseDisabled && !bLastPauseState) continue;
+		if (Module->bTickInPauseDisabled && (bLastPauseState || bModulesPauseState)) continue;
 		Module->Tick(DeltaTime);
 	}
 	return !CleanupManager(DeltaTime);
@@ -103,7 +105,7 @@ bool UStaticTickerManager::EndTicker() const
 	return !TickHandle.IsValid();
 }
 
-void UStaticTickerManager::OnGameStarted(EWorldType::Type /*WorldType*/)
+void UStaticTickerManager::OnGameStarted(UWorld* /*World*/)
 {
 	TryAutoModifyTickerState(ETickerStateType::BeginPlay);
 	for (const auto& ModuleData : TickerModules) ModuleData.Value->OnGameStarted();
@@ -117,6 +119,7 @@ void UStaticTickerManager::OnGameEnded(UWorld* /*World*/)
 
 void UStaticTickerManager::OnGamePaused(bool bPaused)
 {
+	bLastPauseState = bPaused;
 	TryAutoModifyTickerState(bPaused ? ETickerStateType::GamePaused : ETickerStateType::GameUnPaused);
 	for (const auto& ModuleData : TickerModules)
 	{
@@ -125,6 +128,13 @@ void UStaticTickerManager::OnGamePaused(bool bPaused)
 	}
 }
 
+void UStaticTickerManager::OnPauseScopeChanged(UWorld* World, EPauseScope ChangedScopes, EPauseScope PausedScopes)
+{
+	if (!EnumHasAnyFlags(ChangedScopes, EPauseScope::TickerModules)) return;
+	if (!World || !FZeonUtil::GetDefaultWorldTypes().Contains(World->WorldType)) return;
+	bModulesPauseState = EnumHasAnyFlags(PausedScopes, EPauseScope::TickerModules);
+}
+
 
 UTickerModule* UStaticTickerManager::AddModule(const TSubclassOf<UTickerModule>& ModuleClass)
 {
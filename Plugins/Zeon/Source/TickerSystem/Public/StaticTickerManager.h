@@ -21,6 +21,8 @@ enum class ETickerStateType : uint8
 	GameUnPaused,
 };
 
+enum class EPauseScope : uint8;
+
 DECLARE_LOG_CATEGORY_EXTERN(LogStaticTicker, Log, All);
 
 /** Класс, обеспечивающая централизованное управление логикой, работающей во времени через систему модулей. */
@@ -41,19 +43,21 @@ class TICKERSYSTEM_API UStaticTickerManager : public UObject
 	void TryEndTicker(const UTickerModule* Module) const;
 	bool EndTicker() const;
 	
-	void OnGameStarted(EWorldType::Type WorldType);
+	void OnGameStarted(UWorld* World);
 	void OnGameEnded(UWorld* World);
 	void OnGamePaused(bool bPaused);
+	void OnPauseScopeChanged(UWorld* World, EPauseScope ChangedScopes, EPauseScope PausedScopes);
 
 	// ---------------- Vars ----------------
 
 	bool bLastPauseState = false;
+	bool bModulesPauseState = false;
 	float CurrentCleanupTime = 0.f;
-	float CurrentPauseUpdateTime = 0.f;
 	FTSTicker::FDelegateHandle TickHandle;
 	FDelegateHandle GameEndedDelegateHandle;
 	FDelegateHandle GameStartedDelegateHandle;
 	FDelegateHandle GamePauseDelegateHandle;
+	FDelegateHandle PauseScopeDelegateHandle;
 	TMap<TSubclassOf<UTickerModule>, TStrongObjectPtr<UTickerModule>> TickerModules;
 public:
 	UStaticTickerManager();
@@ -68,10 +72,6 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings", meta = (EditCondition = "bUseCleanupSystem"))
 	float CleanupRate = 30.f;
 
-	/** Частота обновления состояния паузы */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
-	float PauseUpdateRate = 0.1f;
-
 	/** Частота обновления главного тикера */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
 	float GlobalTickerUpdateRate = 0.001;
@@ -2,4 +2,144 @@
 #include "PauseManager.h"
 
 TUniquePtr<FPauseManager> FPauseManager::Instance;
-FPauseManager::FOnGamePause FPauseManager::OnGamePause;
\ No newline at end of file
+FPauseManager::FOnGamePause FPauseManager::OnGamePause;
+FPauseManager::FOnWorldPause FPauseManager::OnWorldPause;
+FDelegateHandle FPauseManager::WorldTickStartDelegateHandle;
+FDelegateHandle FPauseManager::WorldCleanupDelegateHandle;
+FPauseManager::FOnPauseScopeChanged FPauseManager::OnPauseScopeChanged;
+uint32 FPauseManager::NextLayerId = 1;
+TMap<TObjectKey<UWorld>, bool> FPauseManager::WorldPauseStates;
+TMap<TObjectKey<UWorld>, FPauseManager::FWorldPauseLayers> FPauseManager::WorldPauseLayers;
+
+void FPauseManager::OnWorldTickStart(UWorld* World, ELevelTick /*TickType*/, float /*DeltaTime*/)
+{
+	// Тик мира приходит и во время паузы, поэтому здесь ловятся переходы из любых источников
+	UpdateWorldPauseState(World);
+}
+
+void FPauseManager::OnWorldCleanup(UWorld* World, bool /*bSessionEnded*/, bool /*bCleanupResources*/)
+{
+	WorldPauseStates.Remove(World);
+	WorldPauseLayers.Remove(World);
+}
+
+void FPauseManager::UpdateWorldPauseState(UWorld* World)
+{
+	if (!World) return;
+
+	const bool bPaused = World->IsPaused();
+	bool& bCachedPaused = WorldPauseStates.FindOrAdd(World, false);
+	if (bCachedPaused == bPaused) return;
+
+	bCachedPaused = bPaused;
+	OnWorldPause.Broadcast(World, bPaused);
+	if (FZeonUtil::GetDefaultWorldTypes().Contains(World->WorldType)) OnGamePause.Broadcast(bPaused);
+}
+
+FName FPauseManager::GetPauseGameReason()
+{
+	static const FName Reason(TEXT("PauseGame"));
+	return Reason;
+}
+
+FPauseLayerHandle FPauseManager::PushPause(UWorld* World, const FName Reason, const EPauseScope Scope)
+{
+	FPauseLayerHandle Handle;
+	if (!World || Scope == EPauseScope::None) return Handle;
+
+	Handle.World = World;
+	Handle.Id = NextLayerId++;
+	if (NextLayerId == 0) NextLayerId = 1;
+
+	FWorldPauseLayers& PauseLayers = WorldPauseLayers.FindOrAdd(World);
+	PauseLayers.Layers.Add({ Handle.Id, Reason, Scope });
+	ApplyPauseLayers(World, PauseLayers);
+	return Handle;
+}
+
+bool FPauseManager::PopPause(FPauseLayerHandle& Handle)
+{
+	if (!Handle.IsValid()) return false;
+
+	UWorld* World = Handle.World.ResolveObjectPtr();
+	FWorldPauseLayers* PauseLayers = WorldPauseLayers.Find(Handle.World);
+	const uint32 Id = Handle.Id;
+	Handle.Invalidate();
+	if (!World || !PauseLayers) return false;
+
+	if (PauseLayers->Layers.RemoveAll([Id](const FPauseLayer& Layer) { return Layer.Id == Id; }) == 0) return false;
+	ApplyPauseLayers(World, *PauseLayers);
+	return true;
+}
+
+bool FPauseManager::PopPause(UWorld* World, const FName Reason)
+{
+	FWorldPauseLayers* PauseLayers = WorldPauseLayers.Find(World);
+	if (!World || !PauseLayers) return false;
+
+	const int32 Index = PauseLayers->Layers.FindLastByPredicate([&Reason](const FPauseLayer& Layer) { return Layer.Reason == Reason; });
+	if (Index == INDEX_NONE) return false;
+
+	PauseLayers->Layers.RemoveAt(Index);
+	ApplyPauseLayers(World, *PauseLayers);
+	return true;
+}
+
+bool FPauseManager::HasPauseReason(const UWorld* World, const FName Reason)
+{
+	const FWorldPauseLayers* PauseLayers = WorldPauseLayers.Find(World);
+	return PauseLayers && PauseLayers->Layers.ContainsByPredicate([&Reason](const FPauseLayer& Layer) { return Layer.Reason == Reason; });
+}
+
+bool FPauseManager::PauseGame(UWorld* World, const bool bPaused)
+{
+	if (!World) return false;
+
+	if (bPaused)
+	{
+		if (HasPauseReason(World, GetPauseGameReason())) return false;
+		return PushPause(World, GetPauseGameReason()).IsValid();
+	}
+
+	const bool bPopped = PopPause(World, GetPauseGameReason());
+
+	// слои больше не держат мир, но он всё ещё на паузе: её поставили в обход слоёв
+	const FWorldPauseLayers* PauseLayers = WorldPauseLayers.Find(World);
+	if (!World->IsPaused() || (PauseLayers && EnumHasAnyFlags(PauseLayers->PausedScopes, EPauseScope::World))) return bPopped;
+
+	const bool bResult = UGameplayStatics::SetGamePaused(World, false);
+	UpdateWorldPauseState(World);
+	return bPopped || bResult;
+}
+
+EPauseScope FPauseManager::GetPausedScopes(const UWorld* World)
+{
+	if (IsGamePaused(World)) return EPauseScope::All;
+	const FWorldPauseLayers* PauseLayers = WorldPauseLayers.Find(World);
+	return PauseLayers ? PauseLayers->PausedScopes : EPauseScope::None;
+}
+
+void FPauseManager::ApplyPauseLayers(UWorld* World, FWorldPauseLayers& PauseLayers)
+{
+	EPauseScope PausedScopes = EPauseScope::None;
+	for (const FPauseLayer& Layer : PauseLayers.Layers) PausedScopes |= Layer.Scope;
+
+	const EPauseScope ChangedScopes = PausedScopes ^ PauseLayers.PausedScopes;
+	if (ChangedScopes == EPauseScope::None) return;
+	PauseLayers.PausedScopes = PausedScopes;
+
+	if (EnumHasAnyFlags(ChangedScopes, EPauseScope::World))
+	{
+		if (EnumHasAnyFlags(PausedScopes, EPauseScope::World))
+		{
+			PauseLayers.bAppliedWorldPause = !World->IsPaused() && UGameplayStatics::SetGamePaused(World, true);
+		}
+		else if (PauseLayers.bAppliedWorldPause)
+		{
+			PauseLayers.bAppliedWorldPause = false;
+			UGameplayStatics::SetGamePaused(World, false);
+		}
+		UpdateWorldPauseState(World);
+	}
+	OnPauseScopeChanged.Broadcast(World, ChangedScopes, PausedScopes);
+}
@@ -3,17 +3,85 @@
 
 #include "CoreMinimal.h"
 #include "ZeonUtilits.h"
+#include "UObject/ObjectKey.h"
 #include "Kismet/GameplayStatics.h"
 
+/** Области, которые может заморозить слой паузы. World останавливает весь мир и подразумевает все остальные */
+enum class EPauseScope : uint8
+{
+	None			= 0,
+	World			= 1 << 0,
+	AI				= 1 << 1,
+	TickerModules	= 1 << 2,
+	Projectiles		= 1 << 3,
+
+	All				= 0xFF
+};
+ENUM_CLASS_FLAGS(EPauseScope);
+
+/** Токен слоя паузы, выдаётся в FPauseManager::PushPause и нужен для снятия именно своего слоя */
+struct FPauseLayerHandle
+{
+	FORCEINLINE bool IsValid() const { return Id != 0; }
+	FORCEINLINE void Invalidate() { Id = 0; }
+
+private:
+	friend class FPauseManager;
+
+	TObjectKey<UWorld> World;
+	uint32 Id = 0;
+};
+
 class ZEON_API FPauseManager
 {
+	/** Слой паузы: кто и что именно поставил на паузу */
+	struct FPauseLayer
+	{
+		uint32 Id = 0;
+		FName Reason;
+		EPauseScope Scope = EPauseScope::None;
+	};
+
+	/** Стек слоёв паузы одного мира */
+	struct FWorldPauseLayers
+	{
+		TArray<FPauseLayer> Layers;
+		EPauseScope PausedScopes = EPauseScope::None;
+		/** Была ли пауза мира выставлена именно слоями, чтобы не снимать чужую паузу */
+		bool bAppliedWorldPause = false;
+	};
+
 	static TUniquePtr<FPauseManager> Instance;
+	static FDelegateHandle WorldTickStartDelegateHandle;
+	static FDelegateHandle WorldCleanupDelegateHandle;
+	static uint32 NextLayerId;
+
+	/** Кэш состояния паузы по мирам, обновляется только на реальных переходах паузы */
+	static TMap<TObjectKey<UWorld>, bool> WorldPauseStates;
+
+	/** Стеки слоёв паузы по мирам */
+	static TMap<TObjectKey<UWorld>, FWorldPauseLayers> WorldPauseLayers;
+
+	/** Пересчитывает итоговые области паузы мира и рассылает ивенты только при их изменении */
+	static void ApplyPauseLayers(UWorld* World, FWorldPauseLayers& PauseLayers);
+
+	/** Имя слоя, которым пользуется PauseGame */
+	static FName GetPauseGameReason();
+
+	static void OnWorldTickStart(UWorld* World, ELevelTick /*TickType*/, float /*DeltaTime*/);
+	static void OnWorldCleanup(UWorld* World, bool /*bSessionEnded*/, bool /*bCleanupResources*/);
+
+	/** Сверяет кэш с реальным состоянием мира и рассылает ивенты при изменении */
+	static void UpdateWorldPauseState(UWorld* World);
 
 public:
 
 	static void Initialize()
 	{
 		if (!Instance) Instance = MakeUnique<FPauseManager>();
+		// повторная инициализация не должна подписываться второй раз
+		if (!WorldTickStartDelegateHandle.IsValid()) WorldTickStartDelegateHandle = FWorldDelegates::OnWorldTickStart.AddStatic(&OnWorldTickStart);
+		if (!WorldCleanupDelegateHandle.IsValid()) WorldCleanupDelegateHandle = FZeonUtil::OnWorldCleanup.AddStatic(&OnWorldCleanup);
 	}
 
 	
@@ -21,6 +89,14 @@ public:
 	{
 		Instance.Reset();
 		OnGamePause.Clear();
+		OnWorldPause.Clear();
+		WorldPauseStates.Empty();
+		WorldPauseLayers.Empty();
+		OnPauseScopeChanged.Clear();
+		FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartDelegateHandle);
+		FZeonUtil::OnWorldCleanup.Remove(WorldCleanupDelegateHandle);
+		WorldTickStartDelegateHandle.Reset();
+		WorldCleanupDelegateHandle.Reset();
 	}
 
 	static FPauseManager& Get()
@@ -29,9 +105,39 @@ public:
 		return *Instance;
 	}
 public:
+	/** Вызывается при смене паузы в игровом мире (типы из FZeonUtil::GetDefaultWorldTypes) */
 	DECLARE_MULTICAST_DELEGATE_OneParam(FOnGamePause, bool /*bPaused*/);
 	static FOnGamePause OnGamePause;
 
+	/** Вызывается при смене паузы в любом мире, независимо от того, кто поставил паузу */
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnWorldPause, UWorld* /*World*/, bool /*bPaused*/);
+	static FOnWorldPause OnWorldPause;
+
+	/** Вызывается при изменении итоговых областей паузы мира. ChangedScopes - изменившиеся области, PausedScopes - все активные */
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnPauseScopeChanged, UWorld* /*World*/, EPauseScope /*ChangedScopes*/, EPauseScope /*PausedScopes*/);
+	static FOnPauseScopeChanged OnPauseScopeChanged;
+
+	/** Добавляет слой паузы с причиной Reason, область активна пока на неё есть хотя бы один слой */
+	static FPauseLayerHandle PushPause(UWorld* World, const FName Reason, const EPauseScope Scope = EPauseScope::World);
+
+	/** Снимает слой по токену, токен после этого инвалидируется */
+	static bool PopPause(FPauseLayerHandle& Handle);
+
+	/** Снимает последний слой с причиной Reason */
+	static bool PopPause(UWorld* World, const FName Reason);
+
+	/** Есть ли в мире слой с причиной Reason */
+	static bool HasPauseReason(const UWorld* World, const FName Reason);
+
+	/** Возвращает все области, которые сейчас стоят на паузе. Реальная пауза мира замораживает все области */
+	static EPauseScope GetPausedScopes(const UWorld* World);
+
+	/** Стоит ли на паузе хотя бы одна из областей Scope */
+	FORCEINLINE static bool IsScopePaused(const UWorld* World, const EPauseScope Scope)
+	{
+		return EnumHasAnyFlags(GetPausedScopes(World), Scope);
+	}
+
 	
 	FORCEINLINE static bool PauseGame(const bool bPaused)
 	{
@@ -48,33 +154,31 @@ public:
 		const auto World = GEngine->GetWorldFromContextObjectChecked(ObjectContext);
 		return PauseGame(World, bPaused);
 	}
-	static bool PauseGame(const UWorld* World, const bool bPaused)
-	{
-		if (UGameplayStatics::IsGamePaused(World) != bPaused)
-		{
-			OnGamePause.Broadcast(bPaused);
-			return UGameplayStatics::SetGamePaused(World, bPaused);
-		}
-		return false;
-	}
+	/**
+	 * Ставит или снимает собственный слой паузы, поэтому не снимает паузу, выставленную другими слоями.
+	 * Паузу, поставленную в обход слоёв (например через UGameplayStatics::SetGamePaused), снимает как раньше, если мир не держит ни один слой
+	 */
+	static bool PauseGame(UWorld* World, const bool bPaused);
 
 	FORCEINLINE static bool IsGamePaused()
 	{
 		const auto World = FZeonUtil::FindWorld();
-		return UGameplayStatics::IsGamePaused(World);
+		return IsGamePaused(World);
 	}
 	FORCEINLINE static bool IsGamePaused(const TSet<EWorldType::Type>& WorldTypes = FZeonUtil::GetDefaultWorldTypes())
 	{
 		const auto World = FZeonUtil::FindWorld(WorldTypes);
-		return UGameplayStatics::IsGamePaused(World);
+		return IsGamePaused(World);
 	}
 	FORCEINLINE static bool IsGamePaused(const UObject* ObjectContext)
 	{
 		const auto World = GEngine->GetWorldFromContextObjectChecked(ObjectContext);
-		return UGameplayStatics::IsGamePaused(World);
+		return IsGamePaused(World);
 	}
+	/** Читает закэшированное состояние, для ещё не отслеживаемого мира спрашивает сам мир */
 	FORCEINLINE static bool IsGamePaused(const UWorld* World)
 	{
+		if (const bool* bCachedPaused = WorldPauseStates.Find(World)) return *bCachedPaused;
 		return UGameplayStatics::IsGamePaused(World);
 	}
 };
\ No newline at end of file
@@ -3,4 +3,52 @@
 
 TUniquePtr<FZeonUtil> FZeonUtil::Instance;
 FDelegateHandle FZeonUtil::PostWorldInitDelegateHandle;
-FZeonUtil::FOnWorldBeginPlay FZeonUtil::OnWorldBeginPlay;
\ No newline at end of file
+FDelegateHandle FZeonUtil::LevelAddedDelegateHandle;
+FDelegateHandle FZeonUtil::LevelRemovedDelegateHandle;
+FDelegateHandle FZeonUtil::WorldBeginTearDownDelegateHandle;
+FDelegateHandle FZeonUtil::WorldCleanupDelegateHandle;
+TMap<TObjectKey<UWorld>, FDelegateHandle> FZeonUtil::WorldBeginPlayDelegateHandles;
+FZeonUtil::FOnWorldInitialized FZeonUtil::OnWorldInitialized;
+FZeonUtil::FOnWorldBeginPlay FZeonUtil::OnWorldBeginPlay;
+FZeonUtil::FOnWorldLevelChanged FZeonUtil::OnLevelAdded;
+FZeonUtil::FOnWorldLevelChanged FZeonUtil::OnLevelRemoved;
+FZeonUtil::FOnWorldBeginTearDown FZeonUtil::OnWorldBeginTearDown;
+FZeonUtil::FOnWorldCleanup FZeonUtil::OnWorldCleanup;
+
+void FZeonUtil::OnPostWorldInitialization(UWorld* World, const UWorld::InitializationValues /*IVS*/)
+{
+	// Мир может инициализироваться повторно, старая подписка не должна копиться
+	RemoveWorldBeginPlayBinding(World);
+	WorldBeginPlayDelegateHandles.Add(World, World->OnWorldBeginPlay.AddLambda([WeakWorld = TWeakObjectPtr<UWorld>(World)]
+	{
+		if (UWorld* BegunWorld = WeakWorld.Get()) OnWorldBeginPlay.Broadcast(BegunWorld);
+	}));
+	OnWorldInitialized.Broadcast(World);
+}
+
+void FZeonUtil::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	OnLevelAdded.Broadcast(World, Level);
+}
+
+void FZeonUtil::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	OnLevelRemoved.Broadcast(World, Level);
+}
+
+void FZeonUtil::OnWorldBeginTearDownInternal(UWorld* World)
+{
+	OnWorldBeginTearDown.Broadcast(World);
+}
+
+void FZeonUtil::OnWorldCleanupInternal(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	RemoveWorldBeginPlayBinding(World);
+	OnWorldCleanup.Broadcast(World, bSessionEnded, bCleanupResources);
+}
+
+void FZeonUtil::RemoveWorldBeginPlayBinding(UWorld* World)
+{
+	FDelegateHandle Handle;
+	if (World && WorldBeginPlayDelegateHandles.RemoveAndCopyValue(World, Handle)) World->OnWorldBeginPlay.Remove(Handle);
+}
@@ -5,16 +5,28 @@
 #include "Engine/World.h"
 #include "Engine/Engine.h"
 #include "Delegates/Delegate.h"
+#include "UObject/ObjectKey.h"
 
 class ZEON_API FZeonUtil
 {
 	static TUniquePtr<FZeonUtil> Instance;
 	static FDelegateHandle PostWorldInitDelegateHandle;
-	
-	static void OnPostWorldInitialization(UWorld* World, const UWorld::InitializationValues /*IVS*/)
-	{
-		World->OnWorldBeginPlay.AddLambda([WorldType = World->WorldType]{ OnWorldBeginPlay.Broadcast(WorldType); });
-	}
+	static FDelegateHandle LevelAddedDelegateHandle;
+	static FDelegateHandle LevelRemovedDelegateHandle;
+	static FDelegateHandle WorldBeginTearDownDelegateHandle;
+	static FDelegateHandle WorldCleanupDelegateHandle;
+
+	/** Подписки на UWorld::OnWorldBeginPlay каждого мира, снимаются при очистке мира */
+	static TMap<TObjectKey<UWorld>, FDelegateHandle> WorldBeginPlayDelegateHandles;
+
+	static void OnPostWorldInitialization(UWorld* World, const UWorld::InitializationValues /*IVS*/);
+	static void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	static void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+	static void OnWorldBeginTearDownInternal(UWorld* World);
+	static void OnWorldCleanupInternal(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	/** Снимает подписку на начало игры конкретного мира */
+	static void RemoveWorldBeginPlayBinding(UWorld* World);
 
 public:
 
@@ -22,13 +34,32 @@ public:
 	{
 		if (!Instance) Instance = MakeUnique<FZeonUtil>();
 		PostWorldInitDelegateHandle = FWorldDelegates::OnPostWorldInitialization.AddStatic(&OnPostWorldInitialization);
+		LevelAddedDelegateHandle = FWorldDelegates::LevelAddedToWorld.AddStatic(&OnLevelAddedToWorld);
+		LevelRemovedDelegateHandle = FWorldDelegates::LevelRemovedFromWorld.AddStatic(&OnLevelRemovedFromWorld);
+		WorldBeginTearDownDelegateHandle = FWorldDelegates::OnWorldBeginTearDown.AddStatic(&OnWorldBeginTearDownInternal);
+		WorldCleanupDelegateHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&OnWorldCleanupInternal);
 	}
 	
 	static void Shutdown()
 	{
+		for (const auto& [WorldKey, Handle] : WorldBeginPlayDelegateHandles)
+		{
+			if (UWorld* World = WorldKey.ResolveObjectPtr()) World->OnWorldBeginPlay.Remove(Handle);
+		}
+		WorldBeginPlayDelegateHandles.Empty();
+
 		Instance.Reset();
+		OnWorldInitialized.Clear();
 		OnWorldBeginPlay.Clear();
+		OnLevelAdded.Clear();
+		OnLevelRemoved.Clear();
+		OnWorldBeginTearDown.Clear();
+		OnWorldCleanup.Clear();
 		FWorldDelegates::OnPostWorldInitialization.Remove(PostWorldInitDelegateHandle);
+		FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedDelegateHandle);
+		FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedDelegateHandle);
+		FWorldDelegates::OnWorldBeginTearDown.Remove(WorldBeginTearDownDelegateHandle);
+		FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupDelegateHandle);
 	}
 
 	static FZeonUtil& Get()
@@ -39,8 +70,29 @@ public:
 
 
 public:
-	DECLARE_MULTICAST_DELEGATE_OneParam(FOnWorldBeginPlay, EWorldType::Type /*WorldType*/);
+	// ---------------- World lifecycle ----------------
+	// Подписка через AddStatic/AddUObject/AddLambda возвращает FDelegateHandle, по которому её и нужно снимать.
+
+	/** Вызывается после инициализации мира */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnWorldInitialized, UWorld* /*World*/);
+	static FOnWorldInitialized OnWorldInitialized;
+
+	/** Вызывается при начале игры в мире */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnWorldBeginPlay, UWorld* /*World*/);
 	static FOnWorldBeginPlay OnWorldBeginPlay;
+
+	/** Вызывается при добавлении или удалении стриминг-уровня из мира, Level может быть nullptr при удалении всех уровней */
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnWorldLevelChanged, UWorld* /*World*/, ULevel* /*Level*/);
+	static FOnWorldLevelChanged OnLevelAdded;
+	static FOnWorldLevelChanged OnLevelRemoved;
+
+	/** Вызывается в начале разрушения мира (конец игры) */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnWorldBeginTearDown, UWorld* /*World*/);
+	static FOnWorldBeginTearDown OnWorldBeginTearDown;
+
+	/** Вызывается при очистке мира, после него мир больше не используется */
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnWorldCleanup, UWorld* /*World*/, bool /*bSessionEnded*/, bool /*bCleanupResources*/);
+	static FOnWorldCleanup OnWorldCleanup;
 	
 
 	FORCEINLINE static const TSet<EWorldType::Type>& GetDefaultWorldTypes()
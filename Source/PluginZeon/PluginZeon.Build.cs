@@ -20,7 +20,7 @@ public class PluginZeon : ModuleRules
 			"UMG"
 		});
 
-		PrivateDependencyModuleNames.AddRange(new string[] { });
+		PrivateDependencyModuleNames.AddRange(new string[] { "Zeon" });
 
 		PublicIncludePaths.AddRange(new string[] {
 			"PluginZeon",
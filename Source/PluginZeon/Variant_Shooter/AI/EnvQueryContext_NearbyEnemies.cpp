@@ -0,0 +1,31 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/EnvQueryContext_NearbyEnemies.h"
+#include "EnvironmentQuery/Items/EnvQueryItemType_Actor.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
+#include "ShooterAIController.h"
+#include "ShooterNPC.h"
+#include "ShooterTeamSpatialHash.h"
+#include "Engine/World.h"
+
+void UEnvQueryContext_NearbyEnemies::ProvideContext(FEnvQueryInstance& QueryInstance, FEnvQueryContextData& ContextData) const
+{
+	// get the controller from the query instance
+	if (AShooterAIController* Controller = Cast<AShooterAIController>(QueryInstance.Owner))
+	{
+		// ensure we're controlling an NPC
+		if (AShooterNPC* NPC = Cast<AShooterNPC>(Controller->GetPawn()))
+		{
+			if (UShooterTeamSpatialHash* TeamHash = NPC->GetWorld()->GetSubsystem<UShooterTeamSpatialHash>())
+			{
+				// add the nearby enemies to the context
+				TArray<AActor*> Enemies;
+				TeamHash->FindEnemiesInRadius(NPC->GetActorLocation(), NPC->GetTeamByte(), SearchRadius, Enemies);
+
+				UEnvQueryItemType_Actor::SetContextHelper(ContextData, Enemies);
+			}
+		}
+	}
+
+}
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentQuery/EnvQueryContext.h"
+#include "EnvQueryContext_NearbyEnemies.generated.h"
+
+/**
+ *  Custom EnvQuery Context that returns the enemies near an NPC
+ *  Uses the team spatial hash instead of scanning actors
+ */
+UCLASS()
+class PLUGINZEON_API UEnvQueryContext_NearbyEnemies : public UEnvQueryContext
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max distance from the NPC to look for enemies */
+	UPROPERTY(EditDefaultsOnly, Category="Context")
+	float SearchRadius = 3000.0f;
+
+public:
+
+	/** Provides the context locations or actors for this EnvQuery */
+	virtual void ProvideContext(FEnvQueryInstance& QueryInstance, FEnvQueryContextData& ContextData) const override;
+
+};
@@ -5,8 +5,14 @@
 #include "ShooterNPC.h"
 #include "Components/StateTreeAIComponent.h"
 #include "Perception/AIPerceptionComponent.h"
+#include "Perception/AISenseConfig.h"
 #include "Navigation/PathFollowingComponent.h"
 #include "AI/Navigation/PathFollowingAgentInterface.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "ShooterAILODSubsystem.h"
+#include "TimerManager.h"
+#include "ShooterSquadSubsystem.h"
+#include "Utility/PauseManager.h"
 
 AShooterAIController::AShooterAIController()
 {
@@ -21,6 +27,14 @@ AShooterAIController::AShooterAIController()
 	AIPerception->OnTargetPerceptionForgotten.AddDynamic(this, &AShooterAIController::OnPerceptionForgotten);
 }
 
+void AShooterAIController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// freeze along with the AI pause scope
+	PauseScopeDelegateHandle = FPauseManager::OnPauseScopeChanged.AddUObject(this, &AShooterAIController::OnPauseScopeChanged);
+}
+
 void AShooterAIController::OnPossess(APawn* InPawn)
 {
 	Super::OnPossess(InPawn);
@@ -33,16 +47,56 @@ void AShooterAIController::OnPossess(APawn* InPawn)
 
 		// subscribe to the pawn's OnDeath delegate
 		NPC->OnPawnDeath.AddDynamic(this, &AShooterAIController::OnPawnDeath);
+
+		// let the AI LOD manage our update rates
+		if (UShooterAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UShooterAILODSubsystem>())
+		{
+			AILOD->RegisterController(this);
+		}
+
+		// join the team's squad
+		if (UShooterSquadSubsystem* Squads = GetWorld()->GetSubsystem<UShooterSquadSubsystem>())
+		{
+			Squads->RegisterMember(this, NPC->GetTeamByte());
+		}
+	}
+}
+
+void AShooterAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// clear the perception flush timer
+	GetWorld()->GetTimerManager().ClearTimer(PerceptionFlushTimer);
+
+	// stop listening to the pause manager
+	FPauseManager::OnPauseScopeChanged.Remove(PauseScopeDelegateHandle);
+
+	// stop the AI LOD management
+	if (UShooterAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UShooterAILODSubsystem>())
+	{
+		AILOD->UnregisterController(this);
+	}
+
+	// leave the squad
+	if (UShooterSquadSubsystem* Squads = GetWorld()->GetSubsystem<UShooterSquadSubsystem>())
+	{
+		Squads->UnregisterMember(this);
 	}
 }
 
 void AShooterAIController::OnPawnDeath()
 {
-	// stop movement
-	GetPathFollowingComponent()->AbortMove(*this, FPathFollowingResultFlags::UserAbort);
+	// stop thinking, moving and shooting
+	StopAI();
 
-	// stop StateTree logic
-	StateTreeAI->StopLogic(FString(""));
+	// pooled pawns keep their controller so they can respawn without rebuilding it
+	const AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn());
+
+	if (NPC && NPC->IsPooled())
+	{
+		return;
+	}
 
 	// unpossess the pawn
 	UnPossess();
@@ -51,6 +105,114 @@ void AShooterAIController::OnPawnDeath()
 	Destroy();
 }
 
+void AShooterAIController::StopAI()
+{
+	// ignore if already stopped
+	if (bAIStopped)
+	{
+		return;
+	}
+
+	bAIStopped = true;
+
+	// stop shooting
+	if (AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn()))
+	{
+		NPC->StopShooting();
+	}
+
+	PausedShootingTarget.Reset();
+
+	// stop movement
+	GetPathFollowingComponent()->AbortMove(*this, FPathFollowingResultFlags::UserAbort);
+
+	// stop StateTree logic
+	if (StateTreeAI->IsRunning())
+	{
+		StateTreeAI->StopLogic(FString(""));
+	}
+
+	// drop any stimuli we haven't processed yet
+	PendingStimuli.Reset();
+	GetWorld()->GetTimerManager().ClearTimer(PerceptionFlushTimer);
+
+	// stop sensing
+	SetPerceptionEnabled(false);
+
+	// stop the AI LOD management
+	if (UShooterAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UShooterAILODSubsystem>())
+	{
+		AILOD->UnregisterController(this);
+	}
+
+	// leave the squad
+	if (UShooterSquadSubsystem* Squads = GetWorld()->GetSubsystem<UShooterSquadSubsystem>())
+	{
+		Squads->UnregisterMember(this);
+	}
+}
+
+void AShooterAIController::RestartAI()
+{
+	AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn());
+
+	if (!NPC)
+	{
+		return;
+	}
+
+	bAIStopped = false;
+
+	// start fresh, without targets or perceptions from the previous life
+	ClearCurrentTarget();
+	PendingStimuli.Reset();
+	SetPerceptionEnabled(true);
+	AIPerception->ForgetAll();
+
+	// let the AI LOD manage our update rates again
+	if (UShooterAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UShooterAILODSubsystem>())
+	{
+		AILOD->RegisterController(this);
+	}
+
+	// rejoin the team's squad
+	if (UShooterSquadSubsystem* Squads = GetWorld()->GetSubsystem<UShooterSquadSubsystem>())
+	{
+		Squads->RegisterMember(this, NPC->GetTeamByte());
+	}
+
+	// run StateTree logic from its initial state
+	if (StateTreeAI->IsRunning())
+	{
+		StateTreeAI->RestartLogic();
+
+	} else {
+
+		StateTreeAI->StartLogic();
+	}
+
+	// a pawn respawned during the AI pause stays frozen until it ends
+	if (bAIPaused)
+	{
+		StateTreeAI->PauseLogic(TEXT("AI paused"));
+	}
+}
+
+void AShooterAIController::SetPerceptionEnabled(bool bEnabled)
+{
+	// toggle every configured sense so no sense queries run for this listener
+	for (auto It = AIPerception->GetSensesConfigIterator(); It; ++It)
+	{
+		if (UAISenseConfig* SenseConfig = *It)
+		{
+			AIPerception->SetSenseEnabled(SenseConfig->GetSenseImplementation(), bEnabled);
+		}
+	}
+
+	// the AI pause keeps the component from ticking on its own
+	AIPerception->SetComponentTickEnabled(bEnabled && !bAIPaused);
+}
+
 void AShooterAIController::SetCurrentTarget(AActor* Target)
 {
 	TargetEnemy = Target;
@@ -61,14 +223,167 @@ void AShooterAIController::ClearCurrentTarget()
 	TargetEnemy = nullptr;
 }
 
+void AShooterAIController::ApplyAILODSettings(const FShooterAILODSettings& Settings)
+{
+	// throttle the StateTree
+	StateTreeAI->SetComponentTickInterval(Settings.StateTreeTickInterval);
+
+	// throttle the pawn's movement
+	if (ACharacter* NPC = Cast<ACharacter>(GetPawn()))
+	{
+		NPC->GetCharacterMovement()->SetComponentTickInterval(Settings.MovementTickInterval);
+	}
+
+	// process perception less often
+	PerceptionFlushInterval = Settings.PerceptionFlushInterval;
+}
+
 void AShooterAIController::OnPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus)
 {
-	// pass the data to the StateTree delegate hook
-	OnShooterPerceptionUpdated.ExecuteIfBound(Actor, Stimulus);
+	// a stopped AI doesn't sense anything until it restarts
+	if (bAIStopped)
+	{
+		return;
+	}
+
+	// keep one stimulus per actor until the next flush
+	if (FAIStimulus* PendingStimulus = PendingStimuli.Find(Actor))
+	{
+		// a sensing change always wins, so losing sight isn't masked by an earlier sighting
+		// between stimuli of the same kind, keep the strongest
+		if (Stimulus.WasSuccessfullySensed() != PendingStimulus->WasSuccessfullySensed() || Stimulus.Strength >= PendingStimulus->Strength)
+		{
+			*PendingStimulus = Stimulus;
+		}
+
+	} else {
+
+		PendingStimuli.Add(Actor, Stimulus);
+	}
+
+	// hold the stimuli while the AI is paused, they get flushed when it resumes
+	if (!bAIPaused)
+	{
+		SchedulePerceptionFlush();
+	}
+}
+
+void AShooterAIController::SchedulePerceptionFlush()
+{
+	// schedule the flush if we haven't already
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+
+	if (!TimerManager.TimerExists(PerceptionFlushTimer))
+	{
+		if (PerceptionFlushInterval > 0.0f)
+		{
+			TimerManager.SetTimer(PerceptionFlushTimer, this, &AShooterAIController::FlushPerception, PerceptionFlushInterval, false);
+
+		} else {
+
+			PerceptionFlushTimer = TimerManager.SetTimerForNextTick(this, &AShooterAIController::FlushPerception);
+		}
+	}
 }
 
 void AShooterAIController::OnPerceptionForgotten(AActor* Actor)
 {
+	// a forgotten actor shouldn't be sensed again by a stale stimulus
+	PendingStimuli.Remove(Actor);
+
 	// pass the data to the StateTree delegate hook
 	OnShooterPerceptionForgotten.ExecuteIfBound(Actor);
 }
+
+void AShooterAIController::FlushPerception()
+{
+	// take the batch, since processing it may generate new stimuli
+	TMap<TWeakObjectPtr<AActor>, FAIStimulus> Stimuli = MoveTemp(PendingStimuli);
+	PendingStimuli.Reset();
+
+	UShooterSquadSubsystem* Squads = GetWorld()->GetSubsystem<UShooterSquadSubsystem>();
+	const AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn());
+
+	// pass each actor's pending stimulus to the StateTree delegate hook
+	for (const TPair<TWeakObjectPtr<AActor>, FAIStimulus>& Pair : Stimuli)
+	{
+		if (AActor* Actor = Pair.Key.Get())
+		{
+			// share what we sensed with the squad
+			if (Squads && NPC && Pair.Value.WasSuccessfullySensed())
+			{
+				Squads->ReportSighting(NPC->GetTeamByte(), Actor, Pair.Value.StimulusLocation);
+			}
+
+			OnShooterPerceptionUpdated.ExecuteIfBound(Actor, Pair.Value);
+		}
+	}
+}
+
+void AShooterAIController::OnPauseScopeChanged(UWorld* World, EPauseScope ChangedScopes, EPauseScope PausedScopes)
+{
+	// ignore other worlds and other scopes
+	if (World != GetWorld() || !EnumHasAnyFlags(ChangedScopes, EPauseScope::AI))
+	{
+		return;
+	}
+
+	SetAIPaused(EnumHasAnyFlags(PausedScopes, EPauseScope::AI));
+}
+
+void AShooterAIController::SetAIPaused(bool bPaused)
+{
+	if (bAIPaused == bPaused)
+	{
+		return;
+	}
+
+	bAIPaused = bPaused;
+
+	// stop ticking the controller and the perception component
+	SetActorTickEnabled(!bPaused);
+	AIPerception->SetComponentTickEnabled(!bPaused && !bAIStopped);
+
+	if (bPaused)
+	{
+		// freeze the StateTree and the current move
+		StateTreeAI->PauseLogic(TEXT("AI paused"));
+		GetPathFollowingComponent()->PauseMove();
+
+		// hold the pending perception flush
+		GetWorld()->GetTimerManager().PauseTimer(PerceptionFlushTimer);
+
+		// don't let the weapon keep firing on its own
+		AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn());
+
+		if (NPC && NPC->IsShooting())
+		{
+			PausedShootingTarget = NPC->GetAimTarget();
+			NPC->StopShooting();
+		}
+
+	} else {
+
+		// resume the StateTree and the current move
+		StateTreeAI->ResumeLogic(TEXT("AI paused"));
+		GetPathFollowingComponent()->ResumeMove();
+
+		// pick the fire back up where the paused shoot task left it
+		AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn());
+
+		if (NPC && !NPC->IsDead() && PausedShootingTarget.IsValid())
+		{
+			NPC->StartShooting(PausedShootingTarget.Get());
+		}
+
+		PausedShootingTarget.Reset();
+
+		// flush whatever was sensed while paused
+		GetWorld()->GetTimerManager().UnPauseTimer(PerceptionFlushTimer);
+
+		if (PendingStimuli.Num() > 0)
+		{
+			SchedulePerceptionFlush();
+		}
+	}
+}
@@ -4,11 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "Perception/AIPerceptionTypes.h"
 #include "ShooterAIController.generated.h"
 
 class UStateTreeAIComponent;
 class UAIPerceptionComponent;
-struct FAIStimulus;
+struct FShooterAILODSettings;
+enum class EPauseScope : uint8;
 
 DECLARE_DELEGATE_TwoParams(FShooterPerceptionUpdatedDelegate, AActor*, const FAIStimulus&);
 DECLARE_DELEGATE_OneParam(FShooterPerceptionForgottenDelegate, AActor*);
@@ -38,6 +40,27 @@ protected:
 	/** Enemy currently being targeted */
 	TObjectPtr<AActor> TargetEnemy;
 
+	/** Latest sensing state per actor since the last perception flush. Strongest stimulus while the state doesn't change */
+	TMap<TWeakObjectPtr<AActor>, FAIStimulus> PendingStimuli;
+
+	/** Time between perception flushes. Zero flushes on the next frame. Set by the AI LOD */
+	float PerceptionFlushInterval = 0.0f;
+
+	/** Timer to process the coalesced stimuli */
+	FTimerHandle PerceptionFlushTimer;
+
+	/** Set while the AI pause scope is active */
+	bool bAIPaused = false;
+
+	/** Set while the AI is stopped, between the pawn's death or pooling and its respawn */
+	bool bAIStopped = false;
+
+	/** Handle to the pause manager's scope change delegate */
+	FDelegateHandle PauseScopeDelegateHandle;
+
+	/** Actor the pawn was shooting at when the AI got paused */
+	TWeakObjectPtr<AActor> PausedShootingTarget;
+
 public:
 
 	/** Called when an AI perception has been updated. StateTree task delegate hook */
@@ -53,15 +76,34 @@ public:
 
 protected:
 
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
 	/** Pawn initialization */
 	virtual void OnPossess(APawn* InPawn) override;
 
+	/** Gameplay cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 protected:
 
 	/** Called when the possessed pawn dies */
 	UFUNCTION()
 	void OnPawnDeath();
 
+public:
+
+	/** Stops the StateTree, movement, shooting, perception processing and the AI LOD and squad registration. Does nothing if already stopped */
+	void StopAI();
+
+	/** Restarts the AI from scratch for a pawn respawned from the NPC pool */
+	void RestartAI();
+
+protected:
+
+	/** Enables or disables all of the perception component's senses */
+	void SetPerceptionEnabled(bool bEnabled);
+
 public:
 
 	/** Sets the targeted enemy */
@@ -73,6 +115,9 @@ public:
 	/** Returns the targeted enemy */
 	AActor* GetCurrentTarget() const { return TargetEnemy; };
 
+	/** Applies the update rates of an AI LOD bucket to the StateTree and the pawn's movement */
+	void ApplyAILODSettings(const FShooterAILODSettings& Settings);
+
 protected:
 
 	/** Called when the AI perception component updates a perception on a given actor */
@@ -82,4 +127,16 @@ protected:
 	/** Called when the AI perception component forgets a given actor */
 	UFUNCTION()
 	void OnPerceptionForgotten(AActor* Actor);
+
+	/** Schedules the perception flush if it isn't already pending */
+	void SchedulePerceptionFlush();
+
+	/** Passes the coalesced stimuli to the StateTree delegate hook */
+	void FlushPerception();
+
+	/** Freezes or resumes the StateTree, perception and movement when the AI pause scope changes */
+	void OnPauseScopeChanged(UWorld* World, EPauseScope ChangedScopes, EPauseScope PausedScopes);
+
+	/** Freezes or resumes the AI */
+	void SetAIPaused(bool bPaused);
 };
@@ -0,0 +1,158 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterAILODSubsystem.h"
+#include "ShooterAIController.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+void UShooterAILODSubsystem::Deinitialize()
+{
+	Controllers.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterAILODSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// only re-bucket a few times per second
+	TimeUntilUpdate -= DeltaTime;
+
+	if (TimeUntilUpdate > 0.0f)
+	{
+		return;
+	}
+
+	TimeUntilUpdate = UpdateInterval;
+
+	// gather the player locations
+	TArray<FVector, TInlineAllocator<4>> PlayerLocations;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+
+		if (const APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr)
+		{
+			PlayerLocations.Add(PlayerPawn->GetActorLocation());
+		}
+	}
+
+	for (auto It = Controllers.CreateIterator(); It; ++It)
+	{
+		AShooterAIController* Controller = It.Key().Get();
+
+		// drop controllers that went away without unregistering
+		if (!Controller)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		const APawn* NPC = Controller->GetPawn();
+
+		if (!NPC)
+		{
+			continue;
+		}
+
+		EShooterAILOD NewLOD = EShooterAILOD::Near;
+
+		// NPCs with a target always run at full rate
+		if (!IsValid(Controller->GetCurrentTarget()))
+		{
+			// find the closest player
+			float ClosestDistSquared = PlayerLocations.Num() > 0 ? TNumericLimits<float>::Max() : 0.0f;
+
+			for (const FVector& PlayerLocation : PlayerLocations)
+			{
+				ClosestDistSquared = FMath::Min(ClosestDistSquared, FVector::DistSquared(PlayerLocation, NPC->GetActorLocation()));
+			}
+
+			const float ClosestDist = FMath::Sqrt(ClosestDistSquared);
+
+			// move closer as soon as a boundary is crossed, but only move further once past it by the hysteresis distance
+			const EShooterAILOD CloserLOD = GetLODForDistance(ClosestDist);
+			const EShooterAILOD FurtherLOD = GetLODForDistance(ClosestDist - HysteresisDistance);
+
+			NewLOD = It.Value();
+
+			if (CloserLOD < NewLOD)
+			{
+				NewLOD = CloserLOD;
+
+			} else if (FurtherLOD > NewLOD) {
+
+				NewLOD = FurtherLOD;
+			}
+		}
+
+		// apply the bucket update rates on change
+		if (NewLOD != It.Value())
+		{
+			It.Value() = NewLOD;
+			Controller->ApplyAILODSettings(GetLODSettings(NewLOD));
+		}
+	}
+}
+
+TStatId UShooterAILODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterAILODSubsystem, STATGROUP_Tickables);
+}
+
+bool UShooterAILODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterAILODSubsystem::RegisterController(AShooterAIController* Controller)
+{
+	if (!IsValid(Controller))
+	{
+		return;
+	}
+
+	// new NPCs start at full rate until the next evaluation
+	Controllers.Add(Controller, EShooterAILOD::Near);
+	Controller->ApplyAILODSettings(NearSettings);
+}
+
+void UShooterAILODSubsystem::UnregisterController(AShooterAIController* Controller)
+{
+	Controllers.Remove(Controller);
+}
+
+EShooterAILOD UShooterAILODSubsystem::GetControllerLOD(const AShooterAIController* Controller) const
+{
+	const EShooterAILOD* LOD = Controllers.Find(const_cast<AShooterAIController*>(Controller));
+	return LOD ? *LOD : EShooterAILOD::Near;
+}
+
+const FShooterAILODSettings& UShooterAILODSubsystem::GetLODSettings(EShooterAILOD LOD) const
+{
+	switch (LOD)
+	{
+	case EShooterAILOD::Mid:
+		return MidSettings;
+
+	case EShooterAILOD::Far:
+		return FarSettings;
+
+	default:
+		return NearSettings;
+	}
+}
+
+EShooterAILOD UShooterAILODSubsystem::GetLODForDistance(float Distance) const
+{
+	if (Distance >= FarDistance)
+	{
+		return EShooterAILOD::Far;
+	}
+
+	return Distance >= MidDistance ? EShooterAILOD::Mid : EShooterAILOD::Near;
+}
@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterAILODSubsystem.generated.h"
+
+class AShooterAIController;
+
+/**
+ *  Update rate buckets for shooter NPCs
+ */
+UENUM(BlueprintType)
+enum class EShooterAILOD : uint8
+{
+	/** In combat or close to a player. Full update rate */
+	Near,
+
+	/** At medium distance from every player */
+	Mid,
+
+	/** Far from every player */
+	Far
+};
+
+/**
+ *  Update rates applied to an NPC in a given LOD bucket
+ */
+USTRUCT(BlueprintType)
+struct FShooterAILODSettings
+{
+	GENERATED_BODY()
+
+	/** Tick interval for the StateTree component. Zero ticks every frame */
+	UPROPERTY(EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, Units = "s"))
+	float StateTreeTickInterval = 0.0f;
+
+	/** Tick interval for the character movement component. Zero ticks every frame */
+	UPROPERTY(EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, Units = "s"))
+	float MovementTickInterval = 0.0f;
+
+	/** Time between processing batches of coalesced perception stimuli. Zero processes them once per frame */
+	UPROPERTY(EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, Units = "s"))
+	float PerceptionFlushInterval = 0.0f;
+
+	FShooterAILODSettings() = default;
+
+	FShooterAILODSettings(float InStateTreeTickInterval, float InMovementTickInterval, float InPerceptionFlushInterval)
+		: StateTreeTickInterval(InStateTreeTickInterval)
+		, MovementTickInterval(InMovementTickInterval)
+		, PerceptionFlushInterval(InPerceptionFlushInterval)
+	{}
+};
+
+/**
+ *  World subsystem that throttles shooter NPC updates by distance to the players and combat state
+ *  NPCs are sorted into LOD buckets a few times per second, with hysteresis on the bucket distances
+ *  Bucket settings are read from the Game config
+ */
+UCLASS(Config=Game)
+class PLUGINZEON_API UShooterAILODSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Registered controllers and their current LOD */
+	TMap<TWeakObjectPtr<AShooterAIController>, EShooterAILOD> Controllers;
+
+	/** Time left until the next LOD evaluation */
+	float TimeUntilUpdate = 0.0f;
+
+protected:
+
+	/** Time between LOD evaluations */
+	UPROPERTY(Config)
+	float UpdateInterval = 0.25f;
+
+	/** NPCs further than this from every player leave the Near bucket */
+	UPROPERTY(Config)
+	float MidDistance = 2500.0f;
+
+	/** NPCs further than this from every player enter the Far bucket */
+	UPROPERTY(Config)
+	float FarDistance = 6000.0f;
+
+	/** Extra distance an NPC must travel past a bucket boundary before moving to a further bucket */
+	UPROPERTY(Config)
+	float HysteresisDistance = 500.0f;
+
+	/** Update rates for each bucket */
+	UPROPERTY(Config)
+	FShooterAILODSettings NearSettings;
+
+	UPROPERTY(Config)
+	FShooterAILODSettings MidSettings = FShooterAILODSettings(0.1f, 0.05f, 0.1f);
+
+	UPROPERTY(Config)
+	FShooterAILODSettings FarSettings = FShooterAILODSettings(0.5f, 0.1f, 0.25f);
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Periodically re-buckets the registered NPCs */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only run AI LOD in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Starts managing the update rates of an NPC controller */
+	void RegisterController(AShooterAIController* Controller);
+
+	/** Stops managing an NPC controller */
+	void UnregisterController(AShooterAIController* Controller);
+
+	/** Returns the current LOD of an NPC controller */
+	EShooterAILOD GetControllerLOD(const AShooterAIController* Controller) const;
+
+	/** Returns the update rates for a LOD bucket */
+	const FShooterAILODSettings& GetLODSettings(EShooterAILOD LOD) const;
+
+protected:
+
+	/** Returns the bucket for a distance to the closest player */
+	EShooterAILOD GetLODForDistance(float Distance) const;
+};
@@ -0,0 +1,171 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterCombatStateSubsystem.h"
+#include "ShooterNPC.h"
+#include "ShooterGameMode.h"
+#include "Engine/World.h"
+
+void UShooterCombatStateSubsystem::Deinitialize()
+{
+	Health.Empty();
+	Teams.Empty();
+	Dead.Empty();
+	Generations.Empty();
+	NPCs.Empty();
+	FreeIndices.Empty();
+	PendingDamage.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterCombatStateSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingDamage.Num() == 0)
+	{
+		return;
+	}
+
+	KilledIndices.Reset();
+
+	// apply all the queued damage in one pass
+	for (const FPendingDamage& Damage : PendingDamage)
+	{
+		if (Dead[Damage.Index])
+		{
+			continue;
+		}
+
+		Health[Damage.Index] -= Damage.Damage;
+
+		// have we depleted HP?
+		if (Health[Damage.Index] <= 0.0f)
+		{
+			Dead[Damage.Index] = true;
+			KilledIndices.Add(Damage.Index);
+		}
+	}
+
+	// mirror the new health on the actors
+	for (const FPendingDamage& Damage : PendingDamage)
+	{
+		if (AShooterNPC* NPC = NPCs[Damage.Index].Get())
+		{
+			NPC->CurrentHP = Health[Damage.Index];
+		}
+	}
+
+	PendingDamage.Reset();
+
+	if (KilledIndices.Num() == 0)
+	{
+		return;
+	}
+
+	// process all deaths in one pass
+	AShooterGameMode* GM = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode());
+
+	for (const int32 Index : KilledIndices)
+	{
+		// increment the team score
+		if (GM)
+		{
+			GM->IncrementTeamScore(Teams[Index]);
+		}
+
+		// play out the death on the actor
+		if (AShooterNPC* NPC = NPCs[Index].Get())
+		{
+			NPC->HandleCombatDeath();
+		}
+	}
+}
+
+TStatId UShooterCombatStateSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterCombatStateSubsystem, STATGROUP_Tickables);
+}
+
+bool UShooterCombatStateSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FShooterCombatHandle UShooterCombatStateSubsystem::RegisterNPC(AShooterNPC* NPC, float InitialHealth, uint8 TeamByte)
+{
+	FShooterCombatHandle Handle;
+
+	// reuse a free row if possible
+	if (FreeIndices.Num() > 0)
+	{
+		Handle.Index = FreeIndices.Pop(EAllowShrinking::No);
+
+	} else {
+
+		Handle.Index = Health.AddDefaulted();
+		Teams.AddDefaulted();
+		Dead.AddDefaulted();
+		Generations.Add(0);
+		NPCs.AddDefaulted();
+	}
+
+	Handle.Generation = ++Generations[Handle.Index];
+
+	Health[Handle.Index] = InitialHealth;
+	Teams[Handle.Index] = TeamByte;
+	Dead[Handle.Index] = false;
+	NPCs[Handle.Index] = NPC;
+
+	return Handle;
+}
+
+void UShooterCombatStateSubsystem::UnregisterNPC(const FShooterCombatHandle& Handle)
+{
+	if (!IsHandleValid(Handle))
+	{
+		return;
+	}
+
+	// bump the generation so old handles stop resolving, and drop any queued damage
+	++Generations[Handle.Index];
+	Dead[Handle.Index] = true;
+	NPCs[Handle.Index] = nullptr;
+
+	PendingDamage.RemoveAllSwap([&Handle](const FPendingDamage& Damage) { return Damage.Index == Handle.Index; }, EAllowShrinking::No);
+
+	FreeIndices.Add(Handle.Index);
+}
+
+void UShooterCombatStateSubsystem::ApplyDamage(const FShooterCombatHandle& Handle, float Damage)
+{
+	if (IsHandleValid(Handle) && !Dead[Handle.Index])
+	{
+		PendingDamage.Add({ Handle.Index, Damage });
+	}
+}
+
+void UShooterCombatStateSubsystem::ResetHealth(const FShooterCombatHandle& Handle, float NewHealth)
+{
+	if (IsHandleValid(Handle))
+	{
+		Health[Handle.Index] = NewHealth;
+		Dead[Handle.Index] = false;
+	}
+}
+
+float UShooterCombatStateSubsystem::GetHealth(const FShooterCombatHandle& Handle) const
+{
+	return IsHandleValid(Handle) ? Health[Handle.Index] : 0.0f;
+}
+
+bool UShooterCombatStateSubsystem::IsDead(const FShooterCombatHandle& Handle) const
+{
+	return !IsHandleValid(Handle) || Dead[Handle.Index];
+}
+
+bool UShooterCombatStateSubsystem::IsHandleValid(const FShooterCombatHandle& Handle) const
+{
+	return Generations.IsValidIndex(Handle.Index) && Generations[Handle.Index] == Handle.Generation;
+}
@@ -0,0 +1,102 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterCombatStateSubsystem.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  Handle to an NPC's row in the combat state subsystem
+ */
+struct FShooterCombatHandle
+{
+	/** Row index */
+	int32 Index = INDEX_NONE;
+
+	/** Row generation, so handles to recycled rows are rejected */
+	uint32 Generation = 0;
+
+	/** Returns true if this handle was issued by the subsystem */
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	/** Clears the handle */
+	void Invalidate() { Index = INDEX_NONE; Generation = 0; }
+};
+
+/**
+ *  World subsystem that owns the combat state of shooter NPCs as packed arrays
+ *  Damage is queued and applied in one linear pass per frame
+ *  Deaths are processed together after the damage pass, and the NPC actors mirror the results
+ */
+UCLASS()
+class PLUGINZEON_API UShooterCombatStateSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Damage waiting to be applied to a row */
+	struct FPendingDamage
+	{
+		int32 Index;
+		float Damage;
+	};
+
+	/** Combat state rows. All arrays share the same index */
+	TArray<float> Health;
+	TArray<uint8> Teams;
+	TArray<bool> Dead;
+	TArray<uint32> Generations;
+	TArray<TWeakObjectPtr<AShooterNPC>> NPCs;
+
+	/** Rows free to be reused */
+	TArray<int32> FreeIndices;
+
+	/** Damage queued since the last pass */
+	TArray<FPendingDamage> PendingDamage;
+
+	/** Scratch list of rows killed by the damage pass */
+	TArray<int32> KilledIndices;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Applies the queued damage and processes deaths */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only track combat state in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Adds a row for an NPC and returns its handle */
+	FShooterCombatHandle RegisterNPC(AShooterNPC* NPC, float InitialHealth, uint8 TeamByte);
+
+	/** Frees an NPC's row */
+	void UnregisterNPC(const FShooterCombatHandle& Handle);
+
+	/** Queues damage for an NPC. It's applied with the next damage pass */
+	void ApplyDamage(const FShooterCombatHandle& Handle, float Damage);
+
+	/** Resets an NPC's health and revives it */
+	void ResetHealth(const FShooterCombatHandle& Handle, float NewHealth);
+
+	/** Returns an NPC's health, or zero for invalid handles */
+	float GetHealth(const FShooterCombatHandle& Handle) const;
+
+	/** Returns true if the NPC is dead or the handle is invalid */
+	bool IsDead(const FShooterCombatHandle& Handle) const;
+
+protected:
+
+	/** Returns true if the handle points to a live row */
+	bool IsHandleValid(const FShooterCombatHandle& Handle) const;
+};
@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterCorpseManager.h"
+#include "GameFramework/Character.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "ShooterNPC.h"
+
+void UShooterCorpseManager::Deinitialize()
+{
+	Corpses.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterCorpseManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// drop corpses that went away without unregistering
+	Corpses.RemoveAll([](const FShooterCorpse& Corpse) { return !Corpse.Character.IsValid(); });
+
+	if (Corpses.Num() == 0)
+	{
+		return;
+	}
+
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// freeze ragdolls that have settled or simulated for too long
+	int32 NumSimulating = 0;
+
+	for (FShooterCorpse& Corpse : Corpses)
+	{
+		if (!Corpse.bSimulating)
+		{
+			continue;
+		}
+
+		if (CurrentTime - Corpse.DeathTime > MaxRagdollSimulationTime || !Corpse.Character->GetMesh()->RigidBodyIsAwake())
+		{
+			FreezeRagdoll(Corpse);
+
+		} else {
+
+			++NumSimulating;
+		}
+	}
+
+	// over the ragdoll budget, so freeze the oldest ones
+	for (int32 Index = 0; Index < Corpses.Num() && NumSimulating > MaxSimulatingRagdolls; ++Index)
+	{
+		if (Corpses[Index].bSimulating)
+		{
+			FreezeRagdoll(Corpses[Index]);
+			--NumSimulating;
+		}
+	}
+
+	// over the corpse budget, so destroy the ones seen least recently
+	while (Corpses.Num() > MaxCorpses)
+	{
+		int32 LeastSeenIndex = 0;
+		float LeastSeenTime = TNumericLimits<float>::Max();
+
+		for (int32 Index = 0; Index < Corpses.Num(); ++Index)
+		{
+			const float LastRenderTime = Corpses[Index].Character->GetMesh()->GetLastRenderTimeOnScreen();
+
+			if (LastRenderTime < LeastSeenTime)
+			{
+				LeastSeenIndex = Index;
+				LeastSeenTime = LastRenderTime;
+			}
+		}
+
+		ACharacter* Character = Corpses[LeastSeenIndex].Character.Get();
+		Corpses.RemoveAt(LeastSeenIndex);
+
+		// let NPCs decide between destruction and going back to their pool
+		if (AShooterNPC* NPC = Cast<AShooterNPC>(Character))
+		{
+			NPC->DeferredDestruction();
+
+		} else {
+
+			Character->Destroy();
+		}
+	}
+}
+
+TStatId UShooterCorpseManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterCorpseManager, STATGROUP_Tickables);
+}
+
+bool UShooterCorpseManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterCorpseManager::RegisterCorpse(ACharacter* Character)
+{
+	if (!IsValid(Character))
+	{
+		return;
+	}
+
+	FShooterCorpse& Corpse = Corpses.AddDefaulted_GetRef();
+	Corpse.Character = Character;
+	Corpse.DeathTime = GetWorld()->GetTimeSeconds();
+}
+
+void UShooterCorpseManager::UnregisterCorpse(ACharacter* Character)
+{
+	Corpses.RemoveAll([Character](const FShooterCorpse& Corpse) { return Corpse.Character.Get() == Character; });
+}
+
+void UShooterCorpseManager::FreezeRagdoll(FShooterCorpse& Corpse)
+{
+	Corpse.bSimulating = false;
+
+	USkeletalMeshComponent* Mesh = Corpse.Character->GetMesh();
+
+	// stop updating the bones so the mesh keeps its last simulated pose
+	Mesh->SetComponentTickEnabled(false);
+
+	// remove the bodies from the physics scene
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
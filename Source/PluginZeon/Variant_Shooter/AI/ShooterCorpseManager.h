@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterCorpseManager.generated.h"
+
+class ACharacter;
+
+/**
+ *  A dead character tracked by the corpse manager
+ */
+struct FShooterCorpse
+{
+	/** Dead character */
+	TWeakObjectPtr<ACharacter> Character;
+
+	/** Game time of death */
+	double DeathTime = 0.0;
+
+	/** True while the ragdoll is still simulating */
+	bool bSimulating = true;
+};
+
+/**
+ *  World subsystem that keeps the physics cost of dead NPCs bounded
+ *  Caps the number of simulating ragdolls by freezing the oldest ones into a static pose
+ *  Caps the number of corpses by removing the ones seen least recently
+ */
+UCLASS(Config=Game)
+class PLUGINZEON_API UShooterCorpseManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Tracked corpses, oldest first */
+	TArray<FShooterCorpse> Corpses;
+
+protected:
+
+	/** Max number of ragdolls simulating at the same time */
+	UPROPERTY(Config)
+	int32 MaxSimulatingRagdolls = 8;
+
+	/** Time a ragdoll can simulate before it's frozen */
+	UPROPERTY(Config)
+	float MaxRagdollSimulationTime = 3.0f;
+
+	/** Max number of corpses in the world */
+	UPROPERTY(Config)
+	int32 MaxCorpses = 24;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Enforces the ragdoll and corpse budgets */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only manage corpses in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Starts tracking a character whose ragdoll has just been enabled */
+	void RegisterCorpse(ACharacter* Character);
+
+	/** Stops tracking a character, usually when it's destroyed or reused */
+	void UnregisterCorpse(ACharacter* Character);
+
+protected:
+
+	/** Stops the ragdoll simulation and keeps the mesh in its current pose */
+	void FreezeRagdoll(FShooterCorpse& Corpse);
+};
@@ -0,0 +1,261 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterLineOfSightSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Camera/CameraComponent.h"
+#include "ShooterNPC.h"
+
+void UShooterLineOfSightSubsystem::Deinitialize()
+{
+	Entries.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterLineOfSightSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UWorld* World = GetWorld();
+	const double CurrentTime = World->GetTimeSeconds();
+
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		FShooterLineOfSightEntry& Entry = It.Value();
+
+		// drop pairs that are gone or that nobody has asked about in a while
+		if (!It.Key().Observer.ResolveObjectPtr() || !It.Key().Target.ResolveObjectPtr() || CurrentTime - Entry.LastRequestTime > UnusedEntryTimeout)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (Entry.PendingTraces.Num() == 0)
+		{
+			continue;
+		}
+
+		// collect the trace results for this pair
+		bool bAllReady = true;
+		bool bExpired = false;
+		bool bHasLineOfSight = false;
+
+		for (const FTraceHandle& TraceHandle : Entry.PendingTraces)
+		{
+			FTraceDatum TraceData;
+
+			if (World->QueryTraceData(TraceHandle, TraceData))
+			{
+				// we only need one unobstructed trace
+				if (TraceData.OutHits.Num() == 0 || !TraceData.OutHits[0].bBlockingHit)
+				{
+					bHasLineOfSight = true;
+				}
+
+			} else if (!World->IsTraceHandleValid(TraceHandle, false)) {
+
+				bExpired = true;
+
+			} else {
+
+				bAllReady = false;
+			}
+		}
+
+		// the results expired before we could read them, so let the pair be requested again
+		if (bExpired)
+		{
+			Entry.PendingTraces.Reset();
+
+		} else if (bAllReady) {
+
+			// save the result along with where the actors were when it was traced
+			Entry.bHasLineOfSight = bHasLineOfSight;
+			Entry.ResultTime = CurrentTime;
+			Entry.ObserverLocation = Entry.PendingObserverLocation;
+			Entry.TargetLocation = Entry.PendingTargetLocation;
+			Entry.PendingTraces.Reset();
+		}
+	}
+}
+
+TStatId UShooterLineOfSightSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterLineOfSightSubsystem, STATGROUP_Tickables);
+}
+
+bool UShooterLineOfSightSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterLineOfSightSubsystem::RequestLineOfSight(AActor* Observer, AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks)
+{
+	if (!IsValid(Observer) || !IsValid(Target))
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+
+	FShooterLineOfSightEntry& Entry = Entries.FindOrAdd(MakeKey(Observer, Target, Test, NumVerticalChecks));
+	Entry.LastRequestTime = World->GetTimeSeconds();
+
+	// dedupe requests for the same pair
+	if (Entry.LastRequestFrame == GFrameCounter || Entry.PendingTraces.Num() > 0)
+	{
+		return;
+	}
+
+	Entry.LastRequestFrame = GFrameCounter;
+	Entry.PendingObserverLocation = Observer->GetActorLocation();
+	Entry.PendingTargetLocation = Target->GetActorLocation();
+
+	// queue the traces
+	const FVector Start = GetTraceStart(Observer, Test);
+
+	TArray<FVector, TInlineAllocator<8>> Ends;
+	GetTraceEnds(Target, Test, NumVerticalChecks, Ends);
+
+	const FCollisionQueryParams QueryParams = GetQueryParams(Observer, Target);
+
+	for (const FVector& End : Ends)
+	{
+		Entry.PendingTraces.Add(World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Visibility, QueryParams));
+	}
+}
+
+bool UShooterLineOfSightSubsystem::TestLineOfSight(AActor* Observer, AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks)
+{
+	if (!IsValid(Observer) || !IsValid(Target))
+	{
+		return false;
+	}
+
+	UWorld* World = GetWorld();
+
+	const FVector Start = GetTraceStart(Observer, Test);
+
+	TArray<FVector, TInlineAllocator<8>> Ends;
+	GetTraceEnds(Target, Test, NumVerticalChecks, Ends);
+
+	const FCollisionQueryParams QueryParams = GetQueryParams(Observer, Target);
+
+	bool bHasLineOfSight = false;
+
+	// run the traces until we find an unobstructed one
+	for (const FVector& End : Ends)
+	{
+		FHitResult OutHit;
+
+		if (!World->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams))
+		{
+			bHasLineOfSight = true;
+			break;
+		}
+	}
+
+	// record the result so other requests can reuse it
+	FShooterLineOfSightEntry& Entry = Entries.FindOrAdd(MakeKey(Observer, Target, Test, NumVerticalChecks));
+	Entry.bHasLineOfSight = bHasLineOfSight;
+	Entry.ResultTime = World->GetTimeSeconds();
+	Entry.LastRequestTime = Entry.ResultTime;
+	Entry.ObserverLocation = Observer->GetActorLocation();
+	Entry.TargetLocation = Target->GetActorLocation();
+
+	return bHasLineOfSight;
+}
+
+bool UShooterLineOfSightSubsystem::GetLineOfSight(const AActor* Observer, const AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks, float MaxAge, float MoveThreshold, bool& bOutHasLineOfSight) const
+{
+	if (!IsValid(Observer) || !IsValid(Target))
+	{
+		return false;
+	}
+
+	const FShooterLineOfSightEntry* Entry = Entries.Find(MakeKey(Observer, Target, Test, NumVerticalChecks));
+
+	// is there a recent enough result?
+	if (!Entry || Entry->ResultTime < 0.0 || GetWorld()->GetTimeSeconds() - Entry->ResultTime > MaxAge)
+	{
+		return false;
+	}
+
+	// has either actor moved too far since the result was traced?
+	const float MoveThresholdSquared = FMath::Square(MoveThreshold);
+
+	if (FVector::DistSquared(Entry->ObserverLocation, Observer->GetActorLocation()) > MoveThresholdSquared
+		|| FVector::DistSquared(Entry->TargetLocation, Target->GetActorLocation()) > MoveThresholdSquared)
+	{
+		return false;
+	}
+
+	bOutHasLineOfSight = Entry->bHasLineOfSight;
+	return true;
+}
+
+FShooterLineOfSightKey UShooterLineOfSightSubsystem::MakeKey(const AActor* Observer, const AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks)
+{
+	FShooterLineOfSightKey Key;
+	Key.Observer = Observer;
+	Key.Target = Target;
+	Key.Test = Test;
+
+	// only eyes tests differ by their number of checks
+	Key.NumVerticalChecks = Test == EShooterLineOfSightTest::Eyes ? NumVerticalChecks : 0;
+
+	return Key;
+}
+
+FVector UShooterLineOfSightSubsystem::GetTraceStart(const AActor* Observer, EShooterLineOfSightTest Test)
+{
+	if (Test == EShooterLineOfSightTest::Center)
+	{
+		return Observer->GetActorLocation();
+	}
+
+	// shooter NPCs look through their first person camera
+	if (const AShooterNPC* NPC = Cast<AShooterNPC>(Observer))
+	{
+		return NPC->GetFirstPersonCameraComponent()->GetComponentLocation();
+	}
+
+	FVector EyesLocation;
+	FRotator EyesRotation;
+	Observer->GetActorEyesViewPoint(EyesLocation, EyesRotation);
+
+	return EyesLocation;
+}
+
+void UShooterLineOfSightSubsystem::GetTraceEnds(const AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks, TArray<FVector, TInlineAllocator<8>>& OutEnds)
+{
+	if (Test == EShooterLineOfSightTest::Center)
+	{
+		OutEnds.Add(Target->GetActorLocation());
+		return;
+	}
+
+	// get the target's bounding box
+	FVector CenterOfMass, Extent;
+	Target->GetActorBounds(true, CenterOfMass, Extent, false);
+
+	// divide the vertical extent by the number of line of sight checks we'll do
+	const float ExtentZOffset = Extent.Z * 2.0f / FMath::Max(NumVerticalChecks, 1);
+
+	for (int32 i = 0; i < NumVerticalChecks - 1; ++i)
+	{
+		OutEnds.Add(CenterOfMass + FVector(0.0f, 0.0f, Extent.Z - ExtentZOffset * i));
+	}
+}
+
+FCollisionQueryParams UShooterLineOfSightSubsystem::GetQueryParams(const AActor* Observer, const AActor* Target)
+{
+	// ignore the observer and target. We want to ensure there's an unobstructed trace not counting them
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterLineOfSight), false);
+	QueryParams.AddIgnoredActor(Observer);
+	QueryParams.AddIgnoredActor(Target);
+
+	return QueryParams;
+}
@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "ShooterLineOfSightSubsystem.generated.h"
+
+/**
+ *  Kind of line of sight test. Results of different tests are cached separately
+ */
+enum class EShooterLineOfSightTest : uint8
+{
+	/** From the observer's eyes to points spread over the target's vertical extent. Passes if any trace is unobstructed */
+	Eyes,
+
+	/** From the observer's location to the target's location */
+	Center
+};
+
+/**
+ *  Identifies a cached line of sight result: the actor pair and the test that was traced between them
+ */
+struct FShooterLineOfSightKey
+{
+	TObjectKey<AActor> Observer;
+	TObjectKey<AActor> Target;
+	EShooterLineOfSightTest Test = EShooterLineOfSightTest::Eyes;
+
+	/** Number of vertical checks of an eyes test. Zero for other tests */
+	int32 NumVerticalChecks = 0;
+
+	bool operator==(const FShooterLineOfSightKey& Other) const
+	{
+		return Observer == Other.Observer && Target == Other.Target && Test == Other.Test && NumVerticalChecks == Other.NumVerticalChecks;
+	}
+
+	friend uint32 GetTypeHash(const FShooterLineOfSightKey& Key)
+	{
+		return HashCombineFast(HashCombineFast(GetTypeHash(Key.Observer), GetTypeHash(Key.Target)), GetTypeHash((static_cast<uint32>(Key.Test) << 24) | static_cast<uint32>(Key.NumVerticalChecks)));
+	}
+};
+
+/**
+ *  Latest line of sight state between an observer and a target
+ */
+struct FShooterLineOfSightEntry
+{
+	/** Result of the last completed check */
+	bool bHasLineOfSight = false;
+
+	/** Game time of the last completed check. Negative if there's no result yet */
+	double ResultTime = -1.0;
+
+	/** Actor locations when the last completed check was traced */
+	FVector ObserverLocation = FVector::ZeroVector;
+	FVector TargetLocation = FVector::ZeroVector;
+
+	/** Actor locations when the traces in flight were queued */
+	FVector PendingObserverLocation = FVector::ZeroVector;
+	FVector PendingTargetLocation = FVector::ZeroVector;
+
+	/** Game time this pair was last requested. Used to drop unused pairs */
+	double LastRequestTime = 0.0;
+
+	/** Frame this pair was last requested. Used to dedupe requests */
+	uint64 LastRequestFrame = 0;
+
+	/** Async traces in flight for this pair */
+	TArray<FTraceHandle, TInlineAllocator<8>> PendingTraces;
+};
+
+/**
+ *  World subsystem that provides shared line of sight checks for shooter NPCs
+ *  Requests for the same observer, target and test are deduped per frame and run as async traces
+ *  Results are cached with the actor locations at trace time, so callers can reuse them until
+ *  they get too old or either actor has moved too far
+ *  Trace points are derived from the test, so every caller asking for the same test gets the same traces
+ */
+UCLASS()
+class PLUGINZEON_API UShooterLineOfSightSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Line of sight state by observer, target and test */
+	TMap<FShooterLineOfSightKey, FShooterLineOfSightEntry> Entries;
+
+	/** Time a pair can go without requests before it's dropped */
+	static constexpr double UnusedEntryTimeout = 2.0;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Collects completed traces */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only run line of sight checks in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Queues the async traces of a test. Ignored if the test was already requested this frame or is still in flight. NumVerticalChecks is only used by eyes tests */
+	void RequestLineOfSight(AActor* Observer, AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks = 0);
+
+	/** Runs the traces of a test right away and records the result */
+	bool TestLineOfSight(AActor* Observer, AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks = 0);
+
+	/** Returns true and sets bOutHasLineOfSight if there's a result for the test no older than MaxAge, and neither actor has moved further than MoveThreshold since it was traced */
+	bool GetLineOfSight(const AActor* Observer, const AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks, float MaxAge, float MoveThreshold, bool& bOutHasLineOfSight) const;
+
+protected:
+
+	/** Builds the cache key of a test */
+	static FShooterLineOfSightKey MakeKey(const AActor* Observer, const AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks);
+
+	/** Returns the trace start of a test */
+	static FVector GetTraceStart(const AActor* Observer, EShooterLineOfSightTest Test);
+
+	/** Builds the trace end points of a test */
+	static void GetTraceEnds(const AActor* Target, EShooterLineOfSightTest Test, int32 NumVerticalChecks, TArray<FVector, TInlineAllocator<8>>& OutEnds);
+
+	/** Builds the query params that ignore both actors */
+	static FCollisionQueryParams GetQueryParams(const AActor* Observer, const AActor* Target);
+};
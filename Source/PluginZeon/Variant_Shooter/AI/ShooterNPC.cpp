@@ -11,18 +11,58 @@
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
+#include "ShooterTeamSpatialHash.h"
+#include "ShooterCorpseManager.h"
+#include "ShooterNPCPool.h"
+#include "ShooterAnimationLODSubsystem.h"
+#include "ShooterWeaponInventoryComponent.h"
+#include "ShooterAIController.h"
+#include "Perception/AIPerceptionSystem.h"
+#include "Perception/AISense_Sight.h"
+
+AShooterNPC::AShooterNPC()
+{
+	// create the weapon inventory
+	WeaponInventory = CreateDefaultSubobject<UShooterWeaponInventoryComponent>(TEXT("Weapon Inventory"));
+
+	// NPCs are never locally controlled, so take the animation LOD's update rate optimizations setting before the mesh registers
+	GetMesh()->bEnableUpdateRateOptimizations = GetDefault<UShooterAnimationLODSubsystem>()->IsUpdateRateOptimizationEnabled();
+}
 
 void AShooterNPC::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// spawn the weapon
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.Owner = this;
-	SpawnParams.Instigator = this;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	// bind the aim trace delegate
+	AimTraceDelegate.BindUObject(this, &AShooterNPC::OnAimTraceCompleted);
+
+	// save the spawn state so the NPC pool can restore it
+	InitialHP = CurrentHP;
+	MeshRelativeTransform = GetMesh()->GetRelativeTransform();
+	MeshCollisionProfile = GetMesh()->GetCollisionProfileName();
+	CapsuleCollisionEnabled = GetCapsuleComponent()->GetCollisionEnabled();
+
+	// add the weapon to the inventory and equip it
+	Weapon = WeaponInventory->AddWeapon(WeaponClass);
+	WeaponInventory->EquipWeaponAtIndex(0);
+
+	// add this character to the team spatial hash
+	if (UShooterTeamSpatialHash* TeamHash = GetWorld()->GetSubsystem<UShooterTeamSpatialHash>())
+	{
+		TeamHash->RegisterActor(this, TeamByte);
+	}
+
+	// let the animation LOD manage our mesh update rates
+	if (UShooterAnimationLODSubsystem* AnimationLOD = GetWorld()->GetSubsystem<UShooterAnimationLODSubsystem>())
+	{
+		AnimationLOD->RegisterCharacter(this);
+	}
 
-	Weapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+	// hand our health over to the combat state subsystem
+	if (UShooterCombatStateSubsystem* CombatState = GetWorld()->GetSubsystem<UShooterCombatStateSubsystem>())
+	{
+		CombatHandle = CombatState->RegisterNPC(this, CurrentHP, TeamByte);
+	}
 }
 
 void AShooterNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -31,6 +71,32 @@ void AShooterNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// remove this character from the team spatial hash
+	if (UShooterTeamSpatialHash* TeamHash = GetWorld()->GetSubsystem<UShooterTeamSpatialHash>())
+	{
+		TeamHash->UnregisterActor(this);
+	}
+
+	// stop tracking our corpse
+	if (UShooterCorpseManager* CorpseManager = GetWorld()->GetSubsystem<UShooterCorpseManager>())
+	{
+		CorpseManager->UnregisterCorpse(this);
+	}
+
+	// stop the animation LOD management
+	if (UShooterAnimationLODSubsystem* AnimationLOD = GetWorld()->GetSubsystem<UShooterAnimationLODSubsystem>())
+	{
+		AnimationLOD->UnregisterCharacter(this);
+	}
+
+	// free our combat state row
+	if (UShooterCombatStateSubsystem* CombatState = GetWorld()->GetSubsystem<UShooterCombatStateSubsystem>())
+	{
+		CombatState->UnregisterNPC(CombatHandle);
+	}
+
+	CombatHandle.Invalidate();
 }
 
 float AShooterNPC::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
@@ -41,6 +107,22 @@ float AShooterNPC::TakeDamage(float Damage, struct FDamageEvent const& DamageEve
 		return 0.0f;
 	}
 
+	// queue the damage in the combat state subsystem. It will process it together with all other damage this frame
+	if (CombatHandle.IsValid())
+	{
+		if (UShooterCombatStateSubsystem* CombatState = GetWorld()->GetSubsystem<UShooterCombatStateSubsystem>())
+		{
+			// the row already died this frame, so this damage will be dropped
+			if (CombatState->IsDead(CombatHandle))
+			{
+				return 0.0f;
+			}
+
+			CombatState->ApplyDamage(CombatHandle, Damage);
+			return Damage;
+		}
+	}
+
 	// Reduce HP
 	CurrentHP -= Damage;
 
@@ -60,8 +142,12 @@ void AShooterNPC::AttachWeaponMeshes(AShooterWeapon* WeaponToAttach)
 	// attach the weapon actor
 	WeaponToAttach->AttachToActor(this, AttachmentRule);
 
-	// attach the weapon meshes
-	WeaponToAttach->GetFirstPersonMesh()->AttachToComponent(GetFirstPersonMesh(), AttachmentRule, FirstPersonWeaponSocket);
+	// attach the weapon meshes. The first person mesh is never seen unless we opted into it
+	if (bUseFirstPersonWeaponMesh)
+	{
+		WeaponToAttach->GetFirstPersonMesh()->AttachToComponent(GetFirstPersonMesh(), AttachmentRule, FirstPersonWeaponSocket);
+	}
+
 	WeaponToAttach->GetThirdPersonMesh()->AttachToComponent(GetMesh(), AttachmentRule, FirstPersonWeaponSocket);
 }
 
@@ -85,47 +171,102 @@ FVector AShooterNPC::GetWeaponTargetLocation()
 	// start aiming from the camera location
 	const FVector AimSource = GetFirstPersonCameraComponent()->GetComponentLocation();
 
-	FVector AimDir, AimTarget = FVector::ZeroVector;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterNPCAim), false);
+	QueryParams.AddIgnoredActor(this);
+
+	FHitResult OutHit;
 
 	// do we have an aim target?
 	if (CurrentAimTarget)
 	{
-		// target the actor location
-		AimTarget = CurrentAimTarget->GetActorLocation();
+		// trace toward the middle of the vertical aim offsets, the spread is applied around the result
+		const float MidAimOffsetZ = (MinAimOffsetZ + MaxAimOffsetZ) * 0.5f;
 
-		// apply a vertical offset to target head/feet
-		AimTarget.Z += FMath::RandRange(MinAimOffsetZ, MaxAimOffsetZ);
+		FVector TargetCenter = CurrentAimTarget->GetActorLocation();
+		TargetCenter.Z += MidAimOffsetZ;
 
-		// get the aim direction and apply randomness in a cone
-		AimDir = (AimTarget - AimSource).GetSafeNormal();
-		AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees(AimDir, AimVarianceHalfAngle);
+		const FVector TraceEnd = AimSource + ((TargetCenter - AimSource).GetSafeNormal() * AimRange);
+
+		// how old is the cached trace for this target?
+		const float AimTraceAge = GetWorld()->GetTimeSeconds() - CachedAimTime;
+		const bool bCacheValid = CachedAimTime >= 0.0f && CachedAimTarget == CurrentAimTarget && AimTraceAge <= MaxAimTraceAge;
+
+		if (!bCacheValid)
+		{
+			// no recent result, so run a visibility trace to see if there's obstructions
+			GetWorld()->LineTraceSingleByChannel(OutHit, AimSource, TraceEnd, ECC_Visibility, QueryParams);
+			CacheAimHit(OutHit);
 
-		
-	} else {
+		} else if (AimTraceAge > MaxAimTraceAge * 0.5f) {
 
-		// no aim target, so just use the camera facing
-		AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees(GetFirstPersonCameraComponent()->GetForwardVector(), AimVarianceHalfAngle);
+			// refresh the cached result before it expires
+			RequestAimTrace(AimSource, TraceEnd);
+		}
 
+		// aim at the obstruction if there is one, or at the target otherwise
+		FVector AimPoint = bCachedAimBlocked ? CachedAimImpact : TargetCenter;
+
+		// apply a vertical offset to target head/feet
+		AimPoint.Z += FMath::RandRange(MinAimOffsetZ, MaxAimOffsetZ) - MidAimOffsetZ;
+
+		// get the aim direction and apply randomness in a cone
+		const FVector AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees((AimPoint - AimSource).GetSafeNormal(), AimVarianceHalfAngle);
+
+		// stop at the obstruction, or keep going up to the aim range
+		return AimSource + (AimDir * (bCachedAimBlocked ? FVector::Dist(AimSource, AimPoint) : AimRange));
 	}
 
-	// calculate the unobstructed aim target location
-	AimTarget = AimSource + (AimDir * AimRange);
+	// no aim target, so just use the camera facing
+	const FVector AimDir = UKismetMathLibrary::RandomUnitVectorInConeInDegrees(GetFirstPersonCameraComponent()->GetForwardVector(), AimVarianceHalfAngle);
 
 	// run a visibility trace to see if there's obstructions
-	FHitResult OutHit;
+	GetWorld()->LineTraceSingleByChannel(OutHit, AimSource, AimSource + (AimDir * AimRange), ECC_Visibility, QueryParams);
+
+	// return either the impact point or the trace end
+	return OutHit.bBlockingHit ? OutHit.ImpactPoint : OutHit.TraceEnd;
+}
+
+void AShooterNPC::RequestAimTrace(const FVector& AimSource, const FVector& AimTarget)
+{
+	// only keep one aim trace in flight
+	if (PendingAimTrace.IsValid())
+	{
+		return;
+	}
 
-	FCollisionQueryParams QueryParams;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterNPCAim), false);
 	QueryParams.AddIgnoredActor(this);
 
-	GetWorld()->LineTraceSingleByChannel(OutHit, AimSource, AimTarget, ECC_Visibility, QueryParams);
+	PendingAimTrace = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, AimSource, AimTarget, ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &AimTraceDelegate);
+}
 
-	// return either the impact point or the trace end
-	return OutHit.bBlockingHit ? OutHit.ImpactPoint : OutHit.TraceEnd;
+void AShooterNPC::OnAimTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceData)
+{
+	// ignore results from traces we no longer care about
+	if (TraceHandle != PendingAimTrace)
+	{
+		return;
+	}
+
+	PendingAimTrace.Invalidate();
+
+	// cache the first obstruction, if any
+	CacheAimHit(TraceData.OutHits.Num() > 0 ? TraceData.OutHits[0] : FHitResult());
 }
 
-void AShooterNPC::AddWeaponClass(const TSubclassOf<AShooterWeapon>& InWeaponClass)
+void AShooterNPC::CacheAimHit(const FHitResult& Hit)
+{
+	// hitting the target itself doesn't count as an obstruction
+	bCachedAimBlocked = Hit.bBlockingHit && Hit.GetActor() != CurrentAimTarget;
+	CachedAimImpact = Hit.ImpactPoint;
+	CachedAimTarget = CurrentAimTarget;
+	CachedAimTime = GetWorld()->GetTimeSeconds();
+}
+
+bool AShooterNPC::AddWeaponClass(const TSubclassOf<AShooterWeapon>& InWeaponClass)
 {
 	// unused
+	return true;
 }
 
 void AShooterNPC::OnWeaponActivated(AShooterWeapon* InWeapon)
@@ -138,6 +279,11 @@ void AShooterNPC::OnWeaponDeactivated(AShooterWeapon* InWeapon)
 	// unused
 }
 
+bool AShooterNPC::UsesFirstPersonWeaponMesh() const
+{
+	return bUseFirstPersonWeaponMesh;
+}
+
 void AShooterNPC::OnSemiWeaponRefire()
 {
 	// are we still shooting?
@@ -156,15 +302,33 @@ void AShooterNPC::Die()
 		return;
 	}
 
-	// raise the dead flag
-	bIsDead = true;
-
 	// increment the team score
 	if (AShooterGameMode* GM = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode()))
 	{
 		GM->IncrementTeamScore(TeamByte);
 	}
 
+	// play out the death
+	HandleCombatDeath();
+}
+
+void AShooterNPC::HandleCombatDeath()
+{
+	// ignore if already dead
+	if (bIsDead)
+	{
+		return;
+	}
+
+	// raise the dead flag
+	bIsDead = true;
+
+	// dead characters are no longer targets
+	if (UShooterTeamSpatialHash* TeamHash = GetWorld()->GetSubsystem<UShooterTeamSpatialHash>())
+	{
+		TeamHash->UnregisterActor(this);
+	}
+
 	// disable capsule collision
 	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
@@ -177,20 +341,152 @@ void AShooterNPC::Die()
 	GetMesh()->SetSimulatePhysics(true);
 	GetMesh()->SetPhysicsBlendWeight(1.0f);
 
+	// let the corpse manager keep the ragdoll and corpse counts within budget
+	if (UShooterCorpseManager* CorpseManager = GetWorld()->GetSubsystem<UShooterCorpseManager>())
+	{
+		CorpseManager->RegisterCorpse(this);
+	}
+
+	// let the controller stop its logic
+	OnPawnDeath.Broadcast();
+
 	// schedule actor destruction
 	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AShooterNPC::DeferredDestruction, DeferredDestructionTime, false);
 }
 
 void AShooterNPC::DeferredDestruction()
 {
+	// pooled NPCs are parked for reuse instead of destroyed
+	if (bPooled)
+	{
+		if (UShooterNPCPool* NPCPool = GetWorld()->GetSubsystem<UShooterNPCPool>())
+		{
+			NPCPool->ReleaseNPC(this);
+			return;
+		}
+	}
+
 	Destroy();
 }
 
+void AShooterNPC::ActivateFromPool(const FTransform& SpawnTransform)
+{
+	bInPool = false;
+
+	// reset the combat and aim state
+	bIsDead = false;
+	bIsShooting = false;
+	CurrentAimTarget = nullptr;
+	CachedAimTime = -1.0f;
+	PendingAimTrace.Invalidate();
+
+	// restore the health
+	CurrentHP = InitialHP;
+
+	if (UShooterCombatStateSubsystem* CombatState = GetWorld()->GetSubsystem<UShooterCombatStateSubsystem>())
+	{
+		CombatState->ResetHealth(CombatHandle, CurrentHP);
+	}
+
+	// put the third person mesh back on the capsule with its animated pose
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+	GetMesh()->SetComponentTickEnabled(true);
+	GetMesh()->SetCollisionProfileName(MeshCollisionProfile);
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	GetMesh()->SetRelativeTransform(MeshRelativeTransform);
+
+	// restore capsule collision
+	GetCapsuleComponent()->SetCollisionEnabled(CapsuleCollisionEnabled);
+
+	// move to the spawn point
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// restore movement
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	// show the character
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	// we're a valid target again
+	if (UShooterTeamSpatialHash* TeamHash = GetWorld()->GetSubsystem<UShooterTeamSpatialHash>())
+	{
+		TeamHash->RegisterActor(this, TeamByte);
+	}
+
+	// let other NPCs see us again
+	UAIPerceptionSystem::RegisterPerceptionStimuliSource(this, UAISense_Sight::StaticClass(), this);
+
+	// refill and show the weapon
+	if (Weapon)
+	{
+		Weapon->ResetAmmo();
+		Weapon->ActivateWeapon();
+	}
+
+	// restart the controller's logic
+	if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+	{
+		AIController->RestartAI();
+	}
+
+	// notify any other listeners
+	OnPawnRespawn.Broadcast();
+}
+
+void AShooterNPC::DeactivateToPool()
+{
+	bInPool = true;
+
+	// clear the death timer
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// stop the controller's logic, in case we're pooled without dying first
+	if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+	{
+		AIController->StopAI();
+	}
+
+	// parked NPCs stay in the world, so stop other NPCs from perceiving us
+	if (UAIPerceptionSystem* PerceptionSystem = UAIPerceptionSystem::GetCurrent(GetWorld()))
+	{
+		PerceptionSystem->UnregisterSource(*this);
+	}
+
+	// stop tracking our corpse
+	if (UShooterCorpseManager* CorpseManager = GetWorld()->GetSubsystem<UShooterCorpseManager>())
+	{
+		CorpseManager->UnregisterCorpse(this);
+	}
+
+	// stop the ragdoll
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// hide the character
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+
+	// hide the weapon
+	if (Weapon)
+	{
+		Weapon->DeactivateWeapon();
+	}
+}
+
 void AShooterNPC::StartShooting(AActor* ActorToShoot)
 {
 	// save the aim target
 	CurrentAimTarget = ActorToShoot;
 
+	// the cached aim result was for a different target, so drop it
+	CachedAimTime = -1.0f;
+	PendingAimTrace.Invalidate();
+
 	// raise the flag
 	bIsShooting = true;
 
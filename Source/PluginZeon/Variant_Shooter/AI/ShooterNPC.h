@@ -5,11 +5,15 @@
 #include "CoreMinimal.h"
 #include "PluginZeonCharacter.h"
 #include "ShooterWeaponHolder.h"
+#include "WorldCollision.h"
+#include "ShooterCombatStateSubsystem.h"
 #include "ShooterNPC.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FPawnDeathDelegate);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FPawnRespawnDelegate);
 
 class AShooterWeapon;
+class UShooterWeaponInventoryComponent;
 
 /**
  *  A simple AI-controlled shooter game NPC
@@ -21,6 +25,10 @@ class PLUGINZEON_API AShooterNPC : public APluginZeonCharacter, public IShooterW
 {
 	GENERATED_BODY()
 
+	/** Holds and equips this character's weapon */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UShooterWeaponInventoryComponent* WeaponInventory;
+
 public:
 
 	/** Current HP for this character. It dies if it reaches zero through damage */
@@ -56,6 +64,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category ="Weapons")
 	FName ThirdPersonWeaponSocket = FName("HandGrip_R");
 
+	/** If false, the first person weapon mesh is never attached, ticked or rendered, and shots come from the third person muzzle */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category ="Weapons")
+	bool bUseFirstPersonWeaponMesh = false;
+
 	/** Max range for aiming calculations */
 	UPROPERTY(EditAnywhere, Category="Aim")
 	float AimRange = 10000.0f;
@@ -72,6 +84,28 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Aim")
 	float MaxAimOffsetZ = -60.0f;
 
+	/** Max age of an aim trace result before aiming falls back to a synchronous trace. An async refresh is requested past half this age */
+	UPROPERTY(EditAnywhere, Category="Aim", meta = (ClampMin = 0, Units = "s"))
+	float MaxAimTraceAge = 0.25f;
+
+	/** Impact point of the last aim trace toward the aim target */
+	FVector CachedAimImpact = FVector::ZeroVector;
+
+	/** If true, the last aim trace was blocked by something other than the aim target */
+	bool bCachedAimBlocked = false;
+
+	/** Aim target the last aim trace was run for */
+	TWeakObjectPtr<AActor> CachedAimTarget;
+
+	/** Game time of the last aim trace result. Negative if there's no valid result */
+	float CachedAimTime = -1.0f;
+
+	/** Handle to the aim trace currently in flight */
+	FTraceHandle PendingAimTrace;
+
+	/** Delegate called when the async aim trace completes */
+	FTraceDelegate AimTraceDelegate;
+
 	/** Actor currently being targeted */
 	TObjectPtr<AActor> CurrentAimTarget;
 
@@ -84,11 +118,38 @@ protected:
 	/** Deferred destruction on death timer */
 	FTimerHandle DeathTimer;
 
+	/** Handle to this character's row in the combat state subsystem */
+	FShooterCombatHandle CombatHandle;
+
+	/** HP to restore when respawning from the pool */
+	float InitialHP = 0.0f;
+
+	/** Spawn state of the third person mesh, restored when respawning from the pool */
+	FTransform MeshRelativeTransform;
+	FName MeshCollisionProfile;
+
+	/** Spawn collision of the capsule, restored when respawning from the pool */
+	TEnumAsByte<ECollisionEnabled::Type> CapsuleCollisionEnabled = ECollisionEnabled::QueryAndPhysics;
+
+	/** If true, this NPC returns to the NPC pool instead of being destroyed */
+	bool bPooled = false;
+
+	/** If true, this NPC is currently parked in the NPC pool */
+	bool bInPool = false;
+
 public:
 
 	/** Delegate called when this NPC dies */
 	FPawnDeathDelegate OnPawnDeath;
 
+	/** Delegate called when this NPC respawns from the pool */
+	FPawnRespawnDelegate OnPawnRespawn;
+
+public:
+
+	/** Constructor */
+	AShooterNPC();
+
 protected:
 
 	/** Gameplay initialization */
@@ -99,7 +160,7 @@ protected:
 
 public:
 
-	/** Handle incoming damage */
+	/** Handle incoming damage. Damage is queued in the combat state subsystem, so HP loss and death resolve on its tick rather than in this call */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
 public:
@@ -122,7 +183,7 @@ public:
 	virtual FVector GetWeaponTargetLocation() override;
 
 	/** Gives a weapon of this class to the owner */
-	virtual void AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass) override;
+	virtual bool AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass) override;
 
 	/** Activates the passed weapon */
 	virtual void OnWeaponActivated(AShooterWeapon* Weapon) override;
@@ -133,6 +194,9 @@ public:
 	/** Notifies the owner that the weapon cooldown has expired and it's ready to shoot again */
 	virtual void OnSemiWeaponRefire() override;
 
+	/** Returns true if the owner ever renders the first person weapon mesh */
+	virtual bool UsesFirstPersonWeaponMesh() const override;
+
 	//~End IShooterWeaponHolder interface
 
 protected:
@@ -140,8 +204,14 @@ protected:
 	/** Called when HP is depleted and the character should die */
 	void Die();
 
-	/** Called after death to destroy the actor */
-	void DeferredDestruction();
+	/** Requests an async obstruction trace along the given aim line */
+	void RequestAimTrace(const FVector& AimSource, const FVector& AimTarget);
+
+	/** Caches the result of the async aim trace */
+	void OnAimTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceData);
+
+	/** Caches an aim trace result for the current aim target */
+	void CacheAimHit(const FHitResult& Hit);
 
 public:
 
@@ -150,4 +220,39 @@ public:
 
 	/** Signals this character to stop shooting */
 	void StopShooting();
+
+	/** Returns true if this character is currently shooting */
+	bool IsShooting() const { return bIsShooting; }
+
+	/** Returns the actor this character is shooting at */
+	AActor* GetAimTarget() const { return CurrentAimTarget; }
+
+	/** Returns true if this character has died and hasn't respawned yet */
+	bool IsDead() const { return bIsDead; }
+
+	/** Returns the team byte for this character */
+	uint8 GetTeamByte() const { return TeamByte; }
+
+	/** Plays out a death decided by the combat state subsystem, which has already handled scoring */
+	void HandleCombatDeath();
+
+	/** Called after death to destroy the actor, or return it to the NPC pool */
+	void DeferredDestruction();
+
+public:
+
+	/** Flags this NPC as owned by the NPC pool */
+	void SetPooled(bool bValue) { bPooled = bValue; }
+
+	/** Returns true if this NPC returns to the NPC pool instead of being destroyed */
+	bool IsPooled() const { return bPooled; }
+
+	/** Returns true if this NPC is currently parked in the NPC pool */
+	bool IsInPool() const { return bInPool; }
+
+	/** Resets this NPC, its controller and its weapon to their spawn state at the given transform */
+	void ActivateFromPool(const FTransform& SpawnTransform);
+
+	/** Hides this NPC and its weapon and stops its ragdoll while it waits in the pool */
+	void DeactivateToPool();
 };
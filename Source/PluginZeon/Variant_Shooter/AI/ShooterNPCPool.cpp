@@ -0,0 +1,83 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterNPCPool.h"
+#include "ShooterNPC.h"
+#include "Engine/World.h"
+
+void UShooterNPCPool::Deinitialize()
+{
+	// the actors themselves are cleaned up with the world
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+AShooterNPC* UShooterNPCPool::AcquireNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& SpawnTransform)
+{
+	if (!NPCClass)
+	{
+		return nullptr;
+	}
+
+	FShooterNPCPoolEntry& Pool = Pools.FindOrAdd(NPCClass);
+
+	// respawn the most recently released NPC
+	while (Pool.FreeNPCs.Num() > 0)
+	{
+		AShooterNPC* NPC = Pool.FreeNPCs.Pop(EAllowShrinking::No);
+
+		// skip any NPC that was destroyed while parked
+		if (IsValid(NPC))
+		{
+			NPC->ActivateFromPool(SpawnTransform);
+			return NPC;
+		}
+	}
+
+	// the pool is empty, so spawn a new NPC
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	AShooterNPC* NPC = GetWorld()->SpawnActor<AShooterNPC>(NPCClass, SpawnTransform, SpawnParams);
+
+	if (NPC)
+	{
+		// flag the NPC so it comes back to us instead of being destroyed
+		NPC->SetPooled(true);
+
+		// keep the pool clean if something else destroys the NPC
+		NPC->OnDestroyed.AddDynamic(this, &UShooterNPCPool::OnPooledNPCDestroyed);
+
+		// spawned NPCs only get a controller automatically if their auto possess setting allows it
+		if (!NPC->GetController())
+		{
+			NPC->SpawnDefaultController();
+		}
+	}
+
+	return NPC;
+}
+
+void UShooterNPCPool::ReleaseNPC(AShooterNPC* NPC)
+{
+	// ignore invalid or already released NPCs
+	if (!IsValid(NPC) || NPC->IsInPool())
+	{
+		return;
+	}
+
+	// park the NPC
+	NPC->DeactivateToPool();
+	Pools.FindOrAdd(NPC->GetClass()).FreeNPCs.Add(NPC);
+}
+
+void UShooterNPCPool::OnPooledNPCDestroyed(AActor* DestroyedActor)
+{
+	AShooterNPC* NPC = Cast<AShooterNPC>(DestroyedActor);
+
+	if (FShooterNPCPoolEntry* Pool = NPC ? Pools.Find(NPC->GetClass()) : nullptr)
+	{
+		Pool->FreeNPCs.Remove(NPC);
+	}
+}
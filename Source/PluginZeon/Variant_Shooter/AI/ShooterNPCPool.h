@@ -0,0 +1,57 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterNPCPool.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  Pooled NPCs for a single NPC class
+ */
+USTRUCT()
+struct FShooterNPCPoolEntry
+{
+	GENERATED_BODY()
+
+	/** Inactive NPCs ready to respawn */
+	UPROPERTY()
+	TArray<TObjectPtr<AShooterNPC>> FreeNPCs;
+};
+
+/**
+ *  World subsystem that recycles shooter NPCs
+ *  Dead NPCs are parked hidden together with their controller and weapon instead of being destroyed
+ *  Respawning resets an existing NPC, controller and weapon to their spawn state, so waves don't pay for actor construction
+ */
+UCLASS()
+class PLUGINZEON_API UShooterNPCPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Pools by NPC class */
+	UPROPERTY()
+	TMap<TSubclassOf<AShooterNPC>, FShooterNPCPoolEntry> Pools;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+public:
+
+	/** Returns a live NPC of the given class at the spawn transform, respawning a pooled one if available */
+	UFUNCTION(BlueprintCallable, Category="NPC Pool")
+	AShooterNPC* AcquireNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& SpawnTransform);
+
+	/** Deactivates the NPC and returns it to its pool */
+	void ReleaseNPC(AShooterNPC* NPC);
+
+protected:
+
+	/** Drops a pooled NPC that was destroyed by something else */
+	UFUNCTION()
+	void OnPooledNPCDestroyed(AActor* DestroyedActor);
+};
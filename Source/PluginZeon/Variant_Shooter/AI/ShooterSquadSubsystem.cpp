@@ -0,0 +1,215 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterSquadSubsystem.h"
+#include "ShooterAIController.h"
+#include "ShooterNPC.h"
+#include "ShooterLineOfSightSubsystem.h"
+#include "ShooterTeamSpatialHash.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+void UShooterSquadSubsystem::Deinitialize()
+{
+	Squads.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterSquadSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// only update a few times per second
+	TimeUntilUpdate -= DeltaTime;
+
+	if (TimeUntilUpdate > 0.0f)
+	{
+		return;
+	}
+
+	TimeUntilUpdate = UpdateInterval;
+
+	for (TPair<uint8, FShooterSquad>& Pair : Squads)
+	{
+		UpdateSquad(Pair.Key, Pair.Value);
+	}
+}
+
+TStatId UShooterSquadSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterSquadSubsystem, STATGROUP_Tickables);
+}
+
+bool UShooterSquadSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterSquadSubsystem::RegisterMember(AShooterAIController* Controller, uint8 TeamByte)
+{
+	if (IsValid(Controller))
+	{
+		Squads.FindOrAdd(TeamByte).Members.AddUnique(Controller);
+	}
+}
+
+void UShooterSquadSubsystem::UnregisterMember(AShooterAIController* Controller)
+{
+	for (TPair<uint8, FShooterSquad>& Pair : Squads)
+	{
+		FShooterSquad& Squad = Pair.Value;
+
+		if (Squad.Members.RemoveSwap(Controller, EAllowShrinking::No) > 0)
+		{
+			// release the member's target
+			TWeakObjectPtr<AActor> Target;
+
+			if (Squad.Assignments.RemoveAndCopyValue(Controller, Target))
+			{
+				if (FShooterSquadSighting* Sighting = Squad.Sightings.Find(Target))
+				{
+					--Sighting->NumAssigned;
+				}
+			}
+
+			return;
+		}
+	}
+}
+
+void UShooterSquadSubsystem::ReportSighting(uint8 TeamByte, AActor* SensedActor, const FVector& Location)
+{
+	FShooterSquad* Squad = Squads.Find(TeamByte);
+
+	if (!Squad || !IsValid(SensedActor))
+	{
+		return;
+	}
+
+	// only track living actors from other teams
+	const UShooterTeamSpatialHash* TeamHash = GetWorld()->GetSubsystem<UShooterTeamSpatialHash>();
+	uint8 SensedTeam = TeamByte;
+
+	if (!TeamHash || !TeamHash->GetActorTeam(SensedActor, SensedTeam) || SensedTeam == TeamByte)
+	{
+		return;
+	}
+
+	FShooterSquadSighting& Sighting = Squad->Sightings.FindOrAdd(SensedActor);
+	Sighting.Location = Location;
+	Sighting.LastSeenTime = GetWorld()->GetTimeSeconds();
+}
+
+AActor* UShooterSquadSubsystem::GetAssignedTarget(const AShooterAIController* Controller, uint8 TeamByte) const
+{
+	if (const FShooterSquad* Squad = Squads.Find(TeamByte))
+	{
+		if (const TWeakObjectPtr<AActor>* Target = Squad->Assignments.Find(const_cast<AShooterAIController*>(Controller)))
+		{
+			return Target->Get();
+		}
+	}
+
+	return nullptr;
+}
+
+void UShooterSquadSubsystem::UpdateSquad(uint8 TeamByte, FShooterSquad& Squad)
+{
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// drop members that went away, died or got pooled without unregistering
+	Squad.Members.RemoveAllSwap([](const TWeakObjectPtr<AShooterAIController>& Member)
+	{
+		const AShooterNPC* NPC = Member.IsValid() ? Cast<AShooterNPC>(Member->GetPawn()) : nullptr;
+		return !NPC || NPC->IsDead() || NPC->IsInPool();
+
+	}, EAllowShrinking::No);
+
+	// drop stale or dead sightings
+	const UShooterTeamSpatialHash* TeamHash = GetWorld()->GetSubsystem<UShooterTeamSpatialHash>();
+
+	for (auto It = Squad.Sightings.CreateIterator(); It; ++It)
+	{
+		uint8 SensedTeam = 0;
+
+		if (!It.Key().IsValid() || CurrentTime - It.Value().LastSeenTime > SightingTimeout || !TeamHash || !TeamHash->GetActorTeam(It.Key().Get(), SensedTeam))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	Squad.Assignments.Reset();
+
+	if (Squad.Members.Num() == 0)
+	{
+		return;
+	}
+
+	UShooterLineOfSightSubsystem* LineOfSight = GetWorld()->GetSubsystem<UShooterLineOfSightSubsystem>();
+
+	// run one shared line of sight check per sighting, from the closest member
+	for (TPair<TWeakObjectPtr<AActor>, FShooterSquadSighting>& Pair : Squad.Sightings)
+	{
+		AActor* Target = Pair.Key.Get();
+		FShooterSquadSighting& Sighting = Pair.Value;
+
+		Sighting.NumAssigned = 0;
+
+		APawn* ClosestMember = nullptr;
+		float ClosestDistSquared = TNumericLimits<float>::Max();
+
+		for (const TWeakObjectPtr<AShooterAIController>& Member : Squad.Members)
+		{
+			APawn* MemberPawn = Member->GetPawn();
+			const float DistSquared = FVector::DistSquared(MemberPawn->GetActorLocation(), Target->GetActorLocation());
+
+			if (DistSquared < ClosestDistSquared)
+			{
+				ClosestMember = MemberPawn;
+				ClosestDistSquared = DistSquared;
+			}
+		}
+
+		if (LineOfSight)
+		{
+			// use the latest result and queue a refresh. Same test as the line of sight condition, so their results are shared
+			LineOfSight->GetLineOfSight(ClosestMember, Target, EShooterLineOfSightTest::Eyes, NumberOfVerticalLineOfSightChecks, MaxLineOfSightAge, LineOfSightMoveThreshold, Sighting.bHasLineOfSight);
+			LineOfSight->RequestLineOfSight(ClosestMember, Target, EShooterLineOfSightTest::Eyes, NumberOfVerticalLineOfSightChecks);
+		}
+	}
+
+	// spread the members over the enemies in sight, preferring close enemies with few members assigned
+	for (const TWeakObjectPtr<AShooterAIController>& Member : Squad.Members)
+	{
+		const FVector MemberLocation = Member->GetPawn()->GetActorLocation();
+
+		FShooterSquadSighting* BestSighting = nullptr;
+		AActor* BestTarget = nullptr;
+		float BestScore = TNumericLimits<float>::Max();
+
+		for (TPair<TWeakObjectPtr<AActor>, FShooterSquadSighting>& Pair : Squad.Sightings)
+		{
+			if (!Pair.Value.bHasLineOfSight)
+			{
+				continue;
+			}
+
+			// each member already on an enemy counts as extra distance
+			const float Score = FVector::Dist(MemberLocation, Pair.Value.Location) * (1.0f + Pair.Value.NumAssigned);
+
+			if (Score < BestScore)
+			{
+				BestSighting = &Pair.Value;
+				BestTarget = Pair.Key.Get();
+				BestScore = Score;
+			}
+		}
+
+		if (BestSighting)
+		{
+			++BestSighting->NumAssigned;
+			Squad.Assignments.Add(Member, BestTarget);
+		}
+	}
+}
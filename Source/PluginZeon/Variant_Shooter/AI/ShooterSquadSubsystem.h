@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterSquadSubsystem.generated.h"
+
+class AShooterAIController;
+
+/**
+ *  An enemy seen by any member of a squad
+ */
+struct FShooterSquadSighting
+{
+	/** Last reported location of the enemy */
+	FVector Location = FVector::ZeroVector;
+
+	/** Game time of the last report */
+	double LastSeenTime = 0.0;
+
+	/** True if the squad's shared line of sight check currently sees the enemy */
+	bool bHasLineOfSight = false;
+
+	/** Number of squad members assigned to this enemy */
+	int32 NumAssigned = 0;
+};
+
+/**
+ *  Shared perception and targeting state for all NPCs on a team
+ */
+struct FShooterSquad
+{
+	/** NPC controllers in this squad */
+	TArray<TWeakObjectPtr<AShooterAIController>> Members;
+
+	/** Enemies seen by any member */
+	TMap<TWeakObjectPtr<AActor>, FShooterSquadSighting> Sightings;
+
+	/** Enemy assigned to each member */
+	TMap<TWeakObjectPtr<AShooterAIController>, TWeakObjectPtr<AActor>> Assignments;
+};
+
+/**
+ *  World subsystem that groups shooter NPCs into squads by team
+ *  Members share what they sense, so each enemy needs only one line of sight check per squad
+ *  Enemies in sight are spread over the members as target assignments
+ */
+UCLASS(Config=Game)
+class PLUGINZEON_API UShooterSquadSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Squads by team byte */
+	TMap<uint8, FShooterSquad> Squads;
+
+	/** Time left until the next squad update */
+	float TimeUntilUpdate = 0.0f;
+
+protected:
+
+	/** Time between squad updates */
+	UPROPERTY(Config)
+	float UpdateInterval = 0.25f;
+
+	/** Time a sighting is kept without new reports */
+	UPROPERTY(Config)
+	float SightingTimeout = 5.0f;
+
+	/** Max age of a shared line of sight result */
+	UPROPERTY(Config)
+	float MaxLineOfSightAge = 0.5f;
+
+	/** Distance either actor can move before a shared line of sight result is discarded */
+	UPROPERTY(Config)
+	float LineOfSightMoveThreshold = 50.0f;
+
+	/** Number of vertical traces for the shared line of sight checks */
+	UPROPERTY(Config)
+	int32 NumberOfVerticalLineOfSightChecks = 5;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Refreshes the shared line of sight and target assignments */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only run squads in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Adds an NPC controller to its team's squad */
+	void RegisterMember(AShooterAIController* Controller, uint8 TeamByte);
+
+	/** Removes an NPC controller from its squad */
+	void UnregisterMember(AShooterAIController* Controller);
+
+	/** Shares an actor sensed by a squad member. Actors on the squad's own team are ignored */
+	void ReportSighting(uint8 TeamByte, AActor* SensedActor, const FVector& Location);
+
+	/** Returns the enemy assigned to the member, or nullptr */
+	AActor* GetAssignedTarget(const AShooterAIController* Controller, uint8 TeamByte) const;
+
+protected:
+
+	/** Updates one squad's shared line of sight and assignments */
+	void UpdateSquad(uint8 TeamByte, FShooterSquad& Squad);
+};
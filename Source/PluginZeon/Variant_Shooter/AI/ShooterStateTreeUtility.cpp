@@ -9,6 +9,9 @@
 #include "Perception/AIPerceptionComponent.h"
 #include "ShooterAIController.h"
 #include "StateTreeAsyncExecutionContext.h"
+#include "ShooterLineOfSightSubsystem.h"
+#include "ShooterTeamSpatialHash.h"
+#include "ShooterSquadSubsystem.h"
 
 bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
@@ -32,41 +35,37 @@ bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionCo
 		return !InstanceData.bMustHaveLineOfSight;
 	}
 
-	// get the target's bounding box
-	FVector CenterOfMass, Extent;
-	InstanceData.Target->GetActorBounds(true, CenterOfMass, Extent, false);
+	UShooterLineOfSightSubsystem* LineOfSight = InstanceData.Character->GetWorld()->GetSubsystem<UShooterLineOfSightSubsystem>();
 
-	// divide the vertical extent by the number of line of sight checks we'll do
-	const float ExtentZOffset = Extent.Z * 2.0f / InstanceData.NumberOfVerticalLineOfSightChecks;
-
-	// get the character's camera location as the source for the line checks
-	const FVector Start = InstanceData.Character->GetFirstPersonCameraComponent()->GetComponentLocation();
+	if (!LineOfSight)
+	{
+		return !InstanceData.bMustHaveLineOfSight;
+	}
 
-	// ignore the character and target. We want to ensure there's an unobstructed trace not counting them
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(InstanceData.Character);
-	QueryParams.AddIgnoredActor(InstanceData.Target);
+	// check from the character's camera to points spread over the target's height
+	const EShooterLineOfSightTest Test = EShooterLineOfSightTest::Eyes;
+	const int32 NumChecks = InstanceData.NumberOfVerticalLineOfSightChecks;
 
-	FHitResult OutHit;
+	// use the latest shared result if it's recent enough
+	bool bHasLineOfSight = false;
 
-	// run a number of vertically offset line traces to the target location
-	for (int32 i = 0; i < InstanceData.NumberOfVerticalLineOfSightChecks - 1; ++i)
+	if (LineOfSight->GetLineOfSight(InstanceData.Character, InstanceData.Target, Test, NumChecks, InstanceData.MaxLineOfSightAge, InstanceData.LineOfSightMoveThreshold, bHasLineOfSight))
 	{
-		// calculate the endpoint for the trace
-		const FVector End = CenterOfMass + FVector(0.0f, 0.0f, Extent.Z - ExtentZOffset * i);
+		// past half its age, queue a shared async refresh so the result doesn't expire. Requests for this pair in the same frame are merged
+		bool bRecentLineOfSight = false;
 
-		InstanceData.Character->GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
-
-		// is the trace unobstructed?
-		if (!OutHit.bBlockingHit)
+		if (!LineOfSight->GetLineOfSight(InstanceData.Character, InstanceData.Target, Test, NumChecks, InstanceData.MaxLineOfSightAge * 0.5f, InstanceData.LineOfSightMoveThreshold, bRecentLineOfSight))
 		{
-			// we only need one unobstructed trace, so terminate early
-			return InstanceData.bMustHaveLineOfSight;
+			LineOfSight->RequestLineOfSight(InstanceData.Character, InstanceData.Target, Test, NumChecks);
 		}
+
+	} else {
+
+		// no usable result, so run the traces right away
+		bHasLineOfSight = LineOfSight->TestLineOfSight(InstanceData.Character, InstanceData.Target, Test, NumChecks);
 	}
 
-	// no line of sight found
-	return !InstanceData.bMustHaveLineOfSight;
+	return bHasLineOfSight == InstanceData.bMustHaveLineOfSight;
 }
 
 #if WITH_EDITOR
@@ -231,6 +230,14 @@ EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionCo
 					return;
 				}
 
+				// dead or parked NPCs keep their tags, but aren't valid targets
+				const AShooterNPC* SensedNPC = Cast<AShooterNPC>(SensedActor);
+
+				if (SensedNPC && (SensedNPC->IsDead() || SensedNPC->IsInPool()))
+				{
+					return;
+				}
+
 				if (SensedActor->ActorHasTag(LambdaInstanceData->SenseTag))
 				{
 					bool bDirectLOS = false;
@@ -245,15 +252,28 @@ EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionCo
 					// is the direction within our perception cone?
 					if (DirDot >= MaxDot)
 					{
-						// run a line trace between the character and the sensed actor
-						FCollisionQueryParams QueryParams;
-						QueryParams.AddIgnoredActor(LambdaInstanceData->Character);
-						QueryParams.AddIgnoredActor(SensedActor);
+						UShooterLineOfSightSubsystem* LineOfSight = LambdaInstanceData->Character->GetWorld()->GetSubsystem<UShooterLineOfSightSubsystem>();
 
-						FHitResult OutHit;
+						if (LineOfSight)
+						{
+							// reuse a cached center to center result if neither actor has moved much since it was traced, otherwise trace it now
+							if (!LineOfSight->GetLineOfSight(LambdaInstanceData->Character, SensedActor, EShooterLineOfSightTest::Center, 0, LambdaInstanceData->MaxLineOfSightAge, LambdaInstanceData->LineOfSightMoveThreshold, bDirectLOS))
+							{
+								bDirectLOS = LineOfSight->TestLineOfSight(LambdaInstanceData->Character, SensedActor, EShooterLineOfSightTest::Center);
+							}
+
+						} else {
 
-						// we have direct line of sight if this trace is unobstructed
-						bDirectLOS = !LambdaInstanceData->Character->GetWorld()->LineTraceSingleByChannel(OutHit, LambdaInstanceData->Character->GetActorLocation(), SensedActor->GetActorLocation(), ECC_Visibility, QueryParams);
+							// run a line trace between the character and the sensed actor
+							FCollisionQueryParams QueryParams;
+							QueryParams.AddIgnoredActor(LambdaInstanceData->Character);
+							QueryParams.AddIgnoredActor(SensedActor);
+
+							FHitResult OutHit;
+
+							// we have direct line of sight if this trace is unobstructed
+							bDirectLOS = !LambdaInstanceData->Character->GetWorld()->LineTraceSingleByChannel(OutHit, LambdaInstanceData->Character->GetActorLocation(), SensedActor->GetActorLocation(), ECC_Visibility, QueryParams);
+						}
 
 					}
 
@@ -365,4 +385,64 @@ FText FStateTreeSenseEnemiesTask::GetDescription(const FGuid& ID, FStateTreeData
 {
 	return FText::FromString("<b>Sense Enemies</b>");
 }
-#endif // WITH_EDITOR
\ No newline at end of file
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+EStateTreeRunStatus FStateTreeFindNearestEnemyTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	InstanceData.TargetActor = nullptr;
+	InstanceData.bHasTarget = false;
+
+	// query the team spatial hash
+	if (UShooterTeamSpatialHash* TeamHash = InstanceData.Character->GetWorld()->GetSubsystem<UShooterTeamSpatialHash>())
+	{
+		InstanceData.TargetActor = TeamHash->FindNearestEnemy(InstanceData.Character->GetActorLocation(), InstanceData.Character->GetTeamByte(), InstanceData.SearchRadius);
+		InstanceData.bHasTarget = InstanceData.TargetActor != nullptr;
+	}
+
+	return InstanceData.bHasTarget ? EStateTreeRunStatus::Succeeded : EStateTreeRunStatus::Failed;
+}
+
+#if WITH_EDITOR
+FText FStateTreeFindNearestEnemyTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Find Nearest Enemy</b>");
+}
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+EStateTreeRunStatus FStateTreeGetSquadTargetTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	InstanceData.TargetActor = nullptr;
+	InstanceData.bHasTarget = false;
+
+	// ask the squad for our assignment
+	if (UShooterSquadSubsystem* Squads = InstanceData.Character->GetWorld()->GetSubsystem<UShooterSquadSubsystem>())
+	{
+		InstanceData.TargetActor = Squads->GetAssignedTarget(InstanceData.Controller, InstanceData.Character->GetTeamByte());
+		InstanceData.bHasTarget = InstanceData.TargetActor != nullptr;
+	}
+
+	// set the controller's target
+	if (InstanceData.bHasTarget)
+	{
+		InstanceData.Controller->SetCurrentTarget(InstanceData.TargetActor);
+	}
+
+	return InstanceData.bHasTarget ? EStateTreeRunStatus::Succeeded : EStateTreeRunStatus::Failed;
+}
+
+#if WITH_EDITOR
+FText FStateTreeGetSquadTargetTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Get Squad Target</b>");
+}
+#endif // WITH_EDITOR
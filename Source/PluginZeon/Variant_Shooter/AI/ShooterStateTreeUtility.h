@@ -36,6 +36,14 @@ struct FStateTreeLineOfSightToTargetConditionInstanceData
 	UPROPERTY(EditAnywhere, Category = "Condition")
 	int32 NumberOfVerticalLineOfSightChecks = 5;
 
+	/** Max age in seconds of a cached line of sight result before the condition runs its own traces. An async refresh is queued past half this age */
+	UPROPERTY(EditAnywhere, Category = "Condition", meta = (ClampMin = 0))
+	float MaxLineOfSightAge = 0.5f;
+
+	/** Distance either actor can move before a cached line of sight result is discarded */
+	UPROPERTY(EditAnywhere, Category = "Condition", meta = (ClampMin = 0))
+	float LineOfSightMoveThreshold = 50.0f;
+
 	/** If true, the condition passes if the character has line of sight */
 	UPROPERTY(EditAnywhere, Category = "Condition")
 	bool bMustHaveLineOfSight = true;
@@ -111,6 +119,54 @@ struct FStateTreeFaceActorTask : public FStateTreeTaskCommonBase
 
 ////////////////////////////////////////////////////////////////////
 
+/**
+ *  Instance data struct for the Find Nearest Enemy StateTree task
+ */
+USTRUCT()
+struct FStateTreeFindNearestEnemyInstanceData
+{
+	GENERATED_BODY()
+
+	/** Searching NPC */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<AShooterNPC> Character;
+
+	/** Max distance to search for enemies */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	float SearchRadius = 5000.0f;
+
+	/** Nearest enemy found */
+	UPROPERTY(EditAnywhere, Category = Output)
+	TObjectPtr<AActor> TargetActor;
+
+	/** True if an enemy was found */
+	UPROPERTY(EditAnywhere, Category = Output)
+	bool bHasTarget = false;
+};
+
+/**
+ *  StateTree task to find the nearest enemy through the team spatial hash
+ *  Succeeds if an enemy was found within the search radius
+ */
+USTRUCT(meta=(DisplayName="Find Nearest Enemy", Category="Shooter"))
+struct FStateTreeFindNearestEnemyTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeFindNearestEnemyInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
+
+////////////////////////////////////////////////////////////////////
+
 /**
  *  Instance data struct for the Face Towards Location StateTree task
  */
@@ -278,6 +334,14 @@ struct FStateTreeSenseEnemiesInstanceData
 	UPROPERTY(EditAnywhere, Category = Parameter)
 	float DirectLineOfSightCone = 85.0f;
 
+	/** Max age in seconds of a cached line of sight result before a new trace is run */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0))
+	float MaxLineOfSightAge = 0.5f;
+
+	/** Distance either actor can move before a cached line of sight result is discarded */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0))
+	float LineOfSightMoveThreshold = 50.0f;
+
 	/** Strength of the last processed stimulus */
 	UPROPERTY(EditAnywhere)
 	float LastStimulusStrength = 0.0f;
@@ -306,4 +370,52 @@ struct FStateTreeSenseEnemiesTask : public FStateTreeTaskCommonBase
 #endif // WITH_EDITOR
 };
 
-////////////////////////////////////////////////////////////////////
\ No newline at end of file
+////////////////////////////////////////////////////////////////////
+
+/**
+ *  Instance data struct for the Get Squad Target StateTree task
+ */
+USTRUCT()
+struct FStateTreeGetSquadTargetInstanceData
+{
+	GENERATED_BODY()
+
+	/** Squad member AI Controller */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<AShooterAIController> Controller;
+
+	/** Squad member NPC */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<AShooterNPC> Character;
+
+	/** Enemy assigned by the squad */
+	UPROPERTY(EditAnywhere, Category = Output)
+	TObjectPtr<AActor> TargetActor;
+
+	/** True if the squad assigned an enemy */
+	UPROPERTY(EditAnywhere, Category = Output)
+	bool bHasTarget = false;
+};
+
+/**
+ *  StateTree task to get the enemy assigned to an NPC by its squad
+ *  Succeeds if the squad has assigned an enemy
+ */
+USTRUCT(meta=(DisplayName="Get Squad Target", Category="Shooter"))
+struct FStateTreeGetSquadTargetTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeGetSquadTargetInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
+
+////////////////////////////////////////////////////////////////////
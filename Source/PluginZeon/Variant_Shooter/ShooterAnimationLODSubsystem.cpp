@@ -0,0 +1,197 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterAnimationLODSubsystem.h"
+#include "PluginZeonCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+void UShooterAnimationLODSubsystem::Deinitialize()
+{
+	Characters.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterAnimationLODSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// possession can change at any time, so check local control every frame
+	for (auto It = Characters.CreateIterator(); It; ++It)
+	{
+		APluginZeonCharacter* Character = It.Key().Get();
+
+		// drop characters that went away without unregistering
+		if (!Character)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		const bool bLocallyControlled = Character->IsPlayerControlled() && Character->IsLocallyControlled();
+
+		if (bLocallyControlled != It.Value().bLocallyControlled)
+		{
+			ApplyLocalControl(Character, It.Value(), bLocallyControlled);
+		}
+	}
+
+	// only re-bucket a few times per second
+	TimeUntilUpdate -= DeltaTime;
+
+	if (TimeUntilUpdate > 0.0f)
+	{
+		return;
+	}
+
+	TimeUntilUpdate = UpdateInterval;
+
+	// gather the local camera locations
+	TArray<FVector, TInlineAllocator<4>> CameraLocations;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+
+		if (PlayerController && PlayerController->IsLocalController() && PlayerController->PlayerCameraManager)
+		{
+			CameraLocations.Add(PlayerController->PlayerCameraManager->GetCameraLocation());
+		}
+	}
+
+	for (TPair<TWeakObjectPtr<APluginZeonCharacter>, FShooterAnimationLODEntry>& Pair : Characters)
+	{
+		APluginZeonCharacter* Character = Pair.Key.Get();
+		FShooterAnimationLODEntry& Entry = Pair.Value;
+
+		EShooterAnimationLOD NewLOD = EShooterAnimationLOD::Near;
+
+		// locally controlled characters always animate at full rate
+		if (!Entry.bLocallyControlled)
+		{
+			// find the closest camera
+			float ClosestDistSquared = CameraLocations.Num() > 0 ? TNumericLimits<float>::Max() : 0.0f;
+
+			for (const FVector& CameraLocation : CameraLocations)
+			{
+				ClosestDistSquared = FMath::Min(ClosestDistSquared, FVector::DistSquared(CameraLocation, Character->GetActorLocation()));
+			}
+
+			const float ClosestDist = FMath::Sqrt(ClosestDistSquared);
+
+			// move closer as soon as a boundary is crossed, but only move further once past it by the hysteresis distance
+			const EShooterAnimationLOD CloserLOD = GetLODForDistance(ClosestDist);
+			const EShooterAnimationLOD FurtherLOD = GetLODForDistance(ClosestDist - HysteresisDistance);
+
+			NewLOD = Entry.LOD;
+
+			if (CloserLOD < NewLOD)
+			{
+				NewLOD = CloserLOD;
+
+			} else if (FurtherLOD > NewLOD) {
+
+				NewLOD = FurtherLOD;
+			}
+		}
+
+		// apply the bucket tick rate on change
+		if (NewLOD != Entry.LOD)
+		{
+			Entry.LOD = NewLOD;
+			Character->GetMesh()->SetComponentTickInterval(GetMeshTickInterval(NewLOD));
+		}
+	}
+}
+
+TStatId UShooterAnimationLODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterAnimationLODSubsystem, STATGROUP_Tickables);
+}
+
+bool UShooterAnimationLODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterAnimationLODSubsystem::RegisterCharacter(APluginZeonCharacter* Character)
+{
+	if (!IsValid(Character))
+	{
+		return;
+	}
+
+	// characters start with their authored setup at full rate until the next check
+	FShooterAnimationLODEntry& Entry = Characters.Add(Character);
+	Entry.DefaultVisibilityBasedAnimTickOption = Character->GetMesh()->VisibilityBasedAnimTickOption;
+}
+
+void UShooterAnimationLODSubsystem::UnregisterCharacter(APluginZeonCharacter* Character)
+{
+	Characters.Remove(Character);
+}
+
+EShooterAnimationLOD UShooterAnimationLODSubsystem::GetCharacterLOD(const APluginZeonCharacter* Character) const
+{
+	const FShooterAnimationLODEntry* Entry = Characters.Find(Character);
+	return Entry ? Entry->LOD : EShooterAnimationLOD::Near;
+}
+
+void UShooterAnimationLODSubsystem::ApplyLocalControl(APluginZeonCharacter* Character, FShooterAnimationLODEntry& Entry, bool bLocallyControlled)
+{
+	Entry.bLocallyControlled = bLocallyControlled;
+
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+
+	if (bLocallyControlled)
+	{
+		// the local player sees its arms and shadows with its body, so restore the authored setup at full rate
+		Character->GetFirstPersonMesh()->SetComponentTickEnabled(true);
+
+		Mesh->VisibilityBasedAnimTickOption = Entry.DefaultVisibilityBasedAnimTickOption;
+		Mesh->SetComponentTickInterval(NearMeshTickInterval);
+
+		Entry.LOD = EShooterAnimationLOD::Near;
+
+	} else {
+
+		// nobody ever sees the first person mesh of a remote or AI character
+		Character->GetFirstPersonMesh()->SetComponentTickEnabled(false);
+
+		// only animate the full body mesh as much as its visibility requires
+		Mesh->VisibilityBasedAnimTickOption = VisibilityBasedAnimTickOption;
+	}
+}
+
+EShooterAnimationLOD UShooterAnimationLODSubsystem::GetLODForDistance(float Distance) const
+{
+	if (Distance > FarDistance)
+	{
+		return EShooterAnimationLOD::Far;
+	}
+
+	if (Distance > MidDistance)
+	{
+		return EShooterAnimationLOD::Mid;
+	}
+
+	return EShooterAnimationLOD::Near;
+}
+
+float UShooterAnimationLODSubsystem::GetMeshTickInterval(EShooterAnimationLOD LOD) const
+{
+	switch (LOD)
+	{
+	case EShooterAnimationLOD::Mid:
+		return MidMeshTickInterval;
+
+	case EShooterAnimationLOD::Far:
+		return FarMeshTickInterval;
+
+	default:
+		return NearMeshTickInterval;
+	}
+}
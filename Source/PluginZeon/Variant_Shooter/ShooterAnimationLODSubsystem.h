@@ -0,0 +1,135 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "ShooterAnimationLODSubsystem.generated.h"
+
+class APluginZeonCharacter;
+
+/**
+ *  Animation update rate buckets for shooter characters
+ */
+UENUM(BlueprintType)
+enum class EShooterAnimationLOD : uint8
+{
+	/** Locally controlled or close to the local camera. Full update rate */
+	Near,
+
+	/** At medium distance from the local camera */
+	Mid,
+
+	/** Far from the local camera */
+	Far
+};
+
+/**
+ *  Animation state tracked for a registered character
+ */
+struct FShooterAnimationLODEntry
+{
+	/** Current distance bucket */
+	EShooterAnimationLOD LOD = EShooterAnimationLOD::Near;
+
+	/** True if the character was locally player controlled at the last check */
+	bool bLocallyControlled = true;
+
+	/** Visibility based tick option the full body mesh was authored with, restored while locally controlled */
+	EVisibilityBasedAnimTickOption DefaultVisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+};
+
+/**
+ *  World subsystem that drives the animation update rates of shooter characters from the Game config
+ *  Non locally controlled characters use visibility based anim ticking and skip their first person mesh. NPCs also use update rate optimizations
+ *  Their full body mesh tick rate is lowered by distance bucket from the local camera, with hysteresis on the bucket distances
+ */
+UCLASS(Config=Game)
+class PLUGINZEON_API UShooterAnimationLODSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Registered characters and their animation state */
+	TMap<TWeakObjectPtr<APluginZeonCharacter>, FShooterAnimationLODEntry> Characters;
+
+	/** Time left until the next distance evaluation */
+	float TimeUntilUpdate = 0.0f;
+
+protected:
+
+	/** If true, NPC meshes are constructed with animation update rate optimizations. Player characters keep their authored setting */
+	UPROPERTY(Config)
+	bool bEnableUpdateRateOptimizations = true;
+
+	/** Visibility based tick option for the full body mesh of non locally controlled characters */
+	UPROPERTY(Config)
+	EVisibilityBasedAnimTickOption VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+
+	/** Time between distance evaluations */
+	UPROPERTY(Config)
+	float UpdateInterval = 0.25f;
+
+	/** Characters further than this from the local camera leave the Near bucket */
+	UPROPERTY(Config)
+	float MidDistance = 2000.0f;
+
+	/** Characters further than this from the local camera enter the Far bucket */
+	UPROPERTY(Config)
+	float FarDistance = 5000.0f;
+
+	/** Extra distance a character must travel past a bucket boundary before moving to a further bucket */
+	UPROPERTY(Config)
+	float HysteresisDistance = 300.0f;
+
+	/** Full body mesh tick interval for each bucket. Zero ticks every frame */
+	UPROPERTY(Config)
+	float NearMeshTickInterval = 0.0f;
+
+	UPROPERTY(Config)
+	float MidMeshTickInterval = 0.033f;
+
+	UPROPERTY(Config)
+	float FarMeshTickInterval = 0.1f;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Tracks local control changes and periodically re-buckets the registered characters */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only run animation LOD in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Starts managing the animation update rates of a character */
+	void RegisterCharacter(APluginZeonCharacter* Character);
+
+	/** Stops managing a character */
+	void UnregisterCharacter(APluginZeonCharacter* Character);
+
+	/** Returns the current animation LOD of a character */
+	EShooterAnimationLOD GetCharacterLOD(const APluginZeonCharacter* Character) const;
+
+	/** Returns true if NPC meshes should use update rate optimizations. Read from the class defaults at construction, since the mesh only picks it up when it registers */
+	bool IsUpdateRateOptimizationEnabled() const { return bEnableUpdateRateOptimizations; }
+
+protected:
+
+	/** Switches a character's meshes between the locally controlled and the remote setup */
+	void ApplyLocalControl(APluginZeonCharacter* Character, FShooterAnimationLODEntry& Entry, bool bLocallyControlled);
+
+	/** Returns the bucket for a distance to the local camera */
+	EShooterAnimationLOD GetLODForDistance(float Distance) const;
+
+	/** Returns the full body mesh tick interval for a bucket */
+	float GetMeshTickInterval(EShooterAnimationLOD LOD) const;
+};
@@ -10,16 +10,57 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "Engine/World.h"
 #include "Camera/CameraComponent.h"
+#include "ShooterTeamSpatialHash.h"
+#include "ShooterUIUpdateAggregator.h"
+#include "ShooterAnimationLODSubsystem.h"
+#include "ShooterWeaponInventoryComponent.h"
 
 AShooterCharacter::AShooterCharacter()
 {
 	// create the noise emitter component
 	PawnNoiseEmitter = CreateDefaultSubobject<UPawnNoiseEmitterComponent>(TEXT("Pawn Noise Emitter"));
 
+	// create the weapon inventory
+	WeaponInventory = CreateDefaultSubobject<UShooterWeaponInventoryComponent>(TEXT("Weapon Inventory"));
+
 	// configure movement
 	GetCharacterMovement()->RotationRate = FRotator(0.0f, 600.0f, 0.0f);
 }
 
+void AShooterCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// add this character to the team spatial hash
+	if (UShooterTeamSpatialHash* TeamHash = GetWorld()->GetSubsystem<UShooterTeamSpatialHash>())
+	{
+		TeamHash->RegisterActor(this, TeamByte);
+	}
+
+	// let the animation LOD manage our mesh update rates
+	if (UShooterAnimationLODSubsystem* AnimationLOD = GetWorld()->GetSubsystem<UShooterAnimationLODSubsystem>())
+	{
+		AnimationLOD->RegisterCharacter(this);
+	}
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// remove this character from the team spatial hash
+	if (UShooterTeamSpatialHash* TeamHash = GetWorld()->GetSubsystem<UShooterTeamSpatialHash>())
+	{
+		TeamHash->UnregisterActor(this);
+	}
+
+	// stop the animation LOD management
+	if (UShooterAnimationLODSubsystem* AnimationLOD = GetWorld()->GetSubsystem<UShooterAnimationLODSubsystem>())
+	{
+		AnimationLOD->UnregisterCharacter(this);
+	}
+}
+
 void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
 	// base class handles move, aim and jump inputs
@@ -53,7 +94,7 @@ float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dam
 	if (CurrentHP <= 0.0f)
 	{
 		// deactivate the weapon
-		if (IsValid(CurrentWeapon))
+		if (AShooterWeapon* CurrentWeapon = WeaponInventory->GetCurrentWeapon())
 		{
 			CurrentWeapon->DeactivateWeapon();
 		}
@@ -72,7 +113,7 @@ float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dam
 void AShooterCharacter::DoStartFiring()
 {
 	// fire the current weapon
-	if (CurrentWeapon)
+	if (AShooterWeapon* CurrentWeapon = WeaponInventory->GetCurrentWeapon())
 	{
 		CurrentWeapon->StartFiring();
 	}
@@ -81,7 +122,7 @@ void AShooterCharacter::DoStartFiring()
 void AShooterCharacter::DoStopFiring()
 {
 	// stop firing the current weapon
-	if (CurrentWeapon)
+	if (AShooterWeapon* CurrentWeapon = WeaponInventory->GetCurrentWeapon())
 	{
 		CurrentWeapon->StopFiring();
 	}
@@ -89,32 +130,8 @@ void AShooterCharacter::DoStopFiring()
 
 void AShooterCharacter::DoSwitchWeapon()
 {
-	// ensure we have at least two weapons two switch between
-	if (OwnedWeapons.Num() > 1)
-	{
-		// deactivate the old weapon
-		CurrentWeapon->DeactivateWeapon();
-
-		// find the index of the current weapon in the owned list
-		int32 WeaponIndex = OwnedWeapons.Find(CurrentWeapon);
-
-		// is this the last weapon?
-		if (WeaponIndex == OwnedWeapons.Num() - 1)
-		{
-			// loop back to the beginning of the array
-			WeaponIndex = 0;
-		}
-		else {
-			// select the next weapon index
-			++WeaponIndex;
-		}
-
-		// set the new weapon as current
-		CurrentWeapon = OwnedWeapons[WeaponIndex];
-
-		// activate the new weapon
-		CurrentWeapon->ActivateWeapon();
-	}
+	// cycle to the next inventory slot
+	WeaponInventory->EquipNextWeapon();
 }
 
 void AShooterCharacter::AttachWeaponMeshes(AShooterWeapon* Weapon)
@@ -143,7 +160,15 @@ void AShooterCharacter::AddWeaponRecoil(float Recoil)
 
 void AShooterCharacter::UpdateWeaponHUD(int32 CurrentAmmo, int32 MagazineSize)
 {
-	OnBulletCountUpdated.Broadcast(MagazineSize, CurrentAmmo);
+	// coalesce the update with any others this frame
+	if (UShooterUIUpdateAggregator* UIAggregator = GetWorld()->GetSubsystem<UShooterUIUpdateAggregator>())
+	{
+		UIAggregator->SetBulletCount(this, MagazineSize, CurrentAmmo);
+
+	} else {
+
+		OnBulletCountUpdated.Broadcast(MagazineSize, CurrentAmmo);
+	}
 }
 
 FVector AShooterCharacter::GetWeaponTargetLocation()
@@ -163,44 +188,30 @@ FVector AShooterCharacter::GetWeaponTargetLocation()
 	return OutHit.bBlockingHit ? OutHit.ImpactPoint : OutHit.TraceEnd;
 }
 
-void AShooterCharacter::AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass)
+bool AShooterCharacter::AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass)
 {
 	// do we already own this weapon?
-	AShooterWeapon* OwnedWeapon = FindWeaponOfType(WeaponClass);
+	if (FindWeaponOfType(WeaponClass))
+	{
+		return true;
+	}
 
-	if (!OwnedWeapon)
+	// add the new weapon to a free inventory slot. Fails if the inventory is full
+	if (!WeaponInventory->AddWeapon(WeaponClass))
 	{
-		// spawn the new weapon
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.Owner = this;
-		SpawnParams.Instigator = this;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-		SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::MultiplyWithRoot;
+		return false;
+	}
 
-		AShooterWeapon* AddedWeapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+	// switch to the new weapon
+	WeaponInventory->EquipWeaponAtIndex(WeaponInventory->GetNumWeapons() - 1);
 
-		if (AddedWeapon)
-		{
-			// add the weapon to the owned list
-			OwnedWeapons.Add(AddedWeapon);
-
-			// if we have an existing weapon, deactivate it
-			if (CurrentWeapon)
-			{
-				CurrentWeapon->DeactivateWeapon();
-			}
-
-			// switch to the new weapon
-			CurrentWeapon = AddedWeapon;
-			CurrentWeapon->ActivateWeapon();
-		}
-	}
+	return true;
 }
 
 void AShooterCharacter::OnWeaponActivated(AShooterWeapon* Weapon)
 {
 	// update the bullet counter
-	OnBulletCountUpdated.Broadcast(Weapon->GetMagazineSize(), Weapon->GetBulletCount());
+	UpdateWeaponHUD(Weapon->GetBulletCount(), Weapon->GetMagazineSize());
 
 	// set the character mesh AnimInstances
 	GetFirstPersonMesh()->SetAnimInstanceClass(Weapon->GetFirstPersonAnimInstanceClass());
@@ -217,18 +228,13 @@ void AShooterCharacter::OnSemiWeaponRefire()
 	// unused
 }
 
-AShooterWeapon* AShooterCharacter::FindWeaponOfType(TSubclassOf<AShooterWeapon> WeaponClass) const
+bool AShooterCharacter::UsesFirstPersonWeaponMesh() const
 {
-	// check each owned weapon
-	for (AShooterWeapon* Weapon : OwnedWeapons)
-	{
-		if (Weapon->IsA(WeaponClass))
-		{
-			return Weapon;
-		}
-	}
+	return true;
+}
 
-	// weapon not found
-	return nullptr;
+AShooterWeapon* AShooterCharacter::FindWeaponOfType(TSubclassOf<AShooterWeapon> WeaponClass) const
+{
+	return WeaponInventory->FindWeaponOfClass(WeaponClass);
 
 }
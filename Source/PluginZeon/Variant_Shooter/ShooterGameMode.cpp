@@ -5,6 +5,7 @@
 #include "ShooterUI.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
+#include "ShooterUIUpdateAggregator.h"
 
 void AShooterGameMode::BeginPlay()
 {
@@ -27,6 +28,13 @@ void AShooterGameMode::IncrementTeamScore(uint8 TeamByte)
 	// increment the score for the given team
 	TeamScores.Add(TeamByte, Score + 1);
 
-	// update the UI
-	ShooterUI->BP_UpdateScore(TeamByte, Score);
+	// update the UI, coalescing with any other kills this frame
+	if (UShooterUIUpdateAggregator* UIAggregator = GetWorld()->GetSubsystem<UShooterUIUpdateAggregator>())
+	{
+		UIAggregator->SetTeamScore(ShooterUI, TeamByte, Score);
+
+	} else {
+
+		ShooterUI->BP_UpdateScore(TeamByte, Score);
+	}
 }
@@ -0,0 +1,146 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterImpactBuffer.h"
+#include "ShooterProjectile.h"
+#include "GameFramework/Character.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+
+void UShooterImpactBuffer::Deinitialize()
+{
+	PendingImpacts.Empty();
+	MergedDamage.Empty();
+	MergedImpulses.Empty();
+	EffectOrder.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterImpactBuffer::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingImpacts.Num() > 0)
+	{
+		ProcessImpacts();
+	}
+}
+
+TStatId UShooterImpactBuffer::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterImpactBuffer, STATGROUP_Tickables);
+}
+
+bool UShooterImpactBuffer::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterImpactBuffer::AddImpact(FShooterBufferedImpact&& Impact)
+{
+	PendingImpacts.Add(MoveTemp(Impact));
+}
+
+void UShooterImpactBuffer::ProcessImpacts()
+{
+	// take the batch, since damage and effects may cause new hits
+	TArray<FShooterBufferedImpact> Impacts = MoveTemp(PendingImpacts);
+	PendingImpacts.Reset();
+
+	MergedDamage.Reset();
+	MergedImpulses.Reset();
+
+	// merge damage per target and impulses per component
+	for (const FShooterBufferedImpact& Impact : Impacts)
+	{
+		if (UPrimitiveComponent* PushedComponent = Impact.PushedComponent.Get())
+		{
+			// weight the impulse location by impulse size so stronger hits dominate the torque
+			FMergedImpulse& Merged = MergedImpulses.FindOrAdd(PushedComponent);
+			const double Weight = FMath::Max(Impact.Impulse.Size(), UE_KINDA_SMALL_NUMBER);
+
+			Merged.Impulse += Impact.Impulse;
+			Merged.WeightedLocation += Impact.Hit.ImpactPoint * Weight;
+			Merged.TotalWeight += Weight;
+		}
+
+		if (AActor* DamagedActor = Impact.DamagedActor.Get())
+		{
+			// only merge hits from the same projectile class, so they share the same damage hook
+			UClass* ProjectileClass = Impact.Projectile.IsValid() ? Impact.Projectile->GetClass() : nullptr;
+
+			FMergedDamage& Merged = MergedDamage.FindOrAdd(MakeTuple(TObjectKey<AActor>(DamagedActor), TObjectKey<AController>(Impact.InstigatorController.Get()), ProjectileClass, Impact.DamageType.Get()));
+
+			Merged.Damage += Impact.Damage;
+
+			if (!Merged.DamageCauser.IsValid())
+			{
+				Merged.DamageCauser = Impact.Projectile;
+				Merged.Hit = Impact.Hit;
+			}
+		}
+	}
+
+	// push physics objects once per component
+	for (const TPair<TObjectKey<UPrimitiveComponent>, FMergedImpulse>& Pair : MergedImpulses)
+	{
+		UPrimitiveComponent* PushedComponent = Pair.Key.ResolveObjectPtr();
+
+		if (PushedComponent && PushedComponent->IsSimulatingPhysics())
+		{
+			PushedComponent->AddImpulseAtLocation(Pair.Value.Impulse, Pair.Value.WeightedLocation / Pair.Value.TotalWeight);
+		}
+	}
+
+	// damage each target once per instigator, projectile class and damage type
+	for (const TPair<FMergedDamageKey, FMergedDamage>& Pair : MergedDamage)
+	{
+		AActor* DamagedActor = Pair.Key.Get<0>().ResolveObjectPtr();
+
+		if (!DamagedActor)
+		{
+			continue;
+		}
+
+		// let the projectile apply the damage so subclasses keep their damage logic
+		AShooterProjectile* DamageCauser = Pair.Value.DamageCauser.Get();
+		ACharacter* DamagedCharacter = Cast<ACharacter>(DamagedActor);
+
+		if (DamageCauser && DamagedCharacter)
+		{
+			DamageCauser->DamageCharacter(DamagedCharacter, Pair.Value.Damage, Pair.Value.Hit);
+
+		} else {
+
+			UGameplayStatics::ApplyDamage(DamagedActor, Pair.Value.Damage, Pair.Key.Get<1>().ResolveObjectPtr(), DamageCauser, Pair.Key.Get<3>());
+		}
+	}
+
+	// play the hit effects grouped by projectile class
+	EffectOrder.Reset(Impacts.Num());
+
+	for (int32 Index = 0; Index < Impacts.Num(); ++Index)
+	{
+		if (Impacts[Index].Projectile.IsValid())
+		{
+			EffectOrder.Add(Index);
+		}
+	}
+
+	EffectOrder.Sort([&Impacts](int32 A, int32 B)
+	{
+		return Impacts[A].Projectile->GetClass() < Impacts[B].Projectile->GetClass();
+	});
+
+	for (int32 Index : EffectOrder)
+	{
+		if (AShooterProjectile* Projectile = Impacts[Index].Projectile.Get())
+		{
+			Projectile->PlayImpactEffects(Impacts[Index].Hit);
+		}
+	}
+}
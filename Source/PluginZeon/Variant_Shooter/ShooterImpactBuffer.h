@@ -0,0 +1,114 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/HitResult.h"
+#include "ShooterImpactBuffer.generated.h"
+
+class AShooterProjectile;
+class UPrimitiveComponent;
+class UDamageType;
+class AController;
+
+/**
+ *  A projectile hit waiting to be processed
+ */
+struct FShooterBufferedImpact
+{
+	/** Projectile that hit. Plays the impact effects */
+	TWeakObjectPtr<AShooterProjectile> Projectile;
+
+	/** Hit data */
+	FHitResult Hit;
+
+	/** Character to damage, if any */
+	TWeakObjectPtr<AActor> DamagedActor;
+
+	/** Damage to apply to the character */
+	float Damage = 0.0f;
+
+	/** Type of damage to apply */
+	TSubclassOf<UDamageType> DamageType;
+
+	/** Controller responsible for the damage */
+	TWeakObjectPtr<AController> InstigatorController;
+
+	/** Simulating physics component to push, if any */
+	TWeakObjectPtr<UPrimitiveComponent> PushedComponent;
+
+	/** Impulse to apply to the physics component */
+	FVector Impulse = FVector::ZeroVector;
+};
+
+/**
+ *  World subsystem that takes projectile hit processing out of the collision callbacks
+ *  Hits are recorded during the frame and processed in a single pass after physics
+ *  Damage to the same target and impulses to the same component are merged, and hit effects are played grouped by projectile class
+ *  Merged damage is applied through the projectile's DamageCharacter, so projectile classes keep control over their damage
+ */
+UCLASS()
+class PLUGINZEON_API UShooterImpactBuffer : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Merged damage for a single target */
+	struct FMergedDamage
+	{
+		float Damage = 0.0f;
+		TWeakObjectPtr<AShooterProjectile> DamageCauser;
+
+		/** First hit on the target, passed to the damage causer's hook */
+		FHitResult Hit;
+	};
+
+	/** Target, instigator, projectile class and damage type of merged damage */
+	using FMergedDamageKey = TTuple<TObjectKey<AActor>, TObjectKey<AController>, UClass*, UClass*>;
+
+	/** Merged impulse for a single physics component */
+	struct FMergedImpulse
+	{
+		FVector Impulse = FVector::ZeroVector;
+		FVector WeightedLocation = FVector::ZeroVector;
+		double TotalWeight = 0.0;
+	};
+
+	/** Hits recorded since the last pass */
+	TArray<FShooterBufferedImpact> PendingImpacts;
+
+	/** Per pass scratch data */
+	TMap<FMergedDamageKey, FMergedDamage> MergedDamage;
+	TMap<TObjectKey<UPrimitiveComponent>, FMergedImpulse> MergedImpulses;
+	TArray<int32> EffectOrder;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Processes the hits recorded this frame */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only buffer impacts in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Records a projectile hit to be processed with the next pass */
+	void AddImpact(FShooterBufferedImpact&& Impact);
+
+	/** Returns the number of hits waiting to be processed */
+	UFUNCTION(BlueprintPure, Category="Impact Buffer")
+	int32 GetNumPendingImpacts() const { return PendingImpacts.Num(); }
+
+protected:
+
+	/** Applies the merged impulses, the merged damage and then the hit effects */
+	void ProcessImpacts();
+};
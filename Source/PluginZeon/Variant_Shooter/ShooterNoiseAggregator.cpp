@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterNoiseAggregator.h"
+#include "Perception/AISense_Hearing.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+void UShooterNoiseAggregator::Deinitialize()
+{
+	PendingNoises.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterNoiseAggregator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingNoises.Num() == 0)
+	{
+		return;
+	}
+
+	// wait for the merge window to close
+	TimeUntilFlush -= DeltaTime;
+
+	if (TimeUntilFlush > 0.0f)
+	{
+		return;
+	}
+
+	FlushNoises();
+}
+
+TStatId UShooterNoiseAggregator::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterNoiseAggregator, STATGROUP_Tickables);
+}
+
+bool UShooterNoiseAggregator::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterNoiseAggregator::ReportNoise(AActor* Instigator, const FVector& Location, float Loudness, float MaxRange, FName Tag)
+{
+	// open a new merge window with the first noise
+	if (PendingNoises.Num() == 0)
+	{
+		TimeUntilFlush = MergeWindow;
+	}
+
+	const FIntVector Cell(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize), FMath::FloorToInt32(Location.Z / CellSize));
+
+	FShooterNoiseEvent* Noise = PendingNoises.Find(MakeTuple(Cell, TObjectKey<AActor>(Instigator), Tag));
+
+	if (!Noise)
+	{
+		// first noise in this cell
+		FShooterNoiseEvent& NewNoise = PendingNoises.Add(MakeTuple(Cell, TObjectKey<AActor>(Instigator), Tag));
+		NewNoise.Location = Location;
+		NewNoise.Loudness = Loudness;
+		NewNoise.MaxRange = MaxRange;
+		NewNoise.Instigator = Instigator;
+		NewNoise.Tag = Tag;
+		return;
+	}
+
+	// keep the loudest noise
+	if (Loudness > Noise->Loudness)
+	{
+		Noise->Location = Location;
+		Noise->Loudness = Loudness;
+	}
+
+	Noise->MaxRange = FMath::Max(Noise->MaxRange, MaxRange);
+}
+
+void UShooterNoiseAggregator::FlushNoises()
+{
+	for (const TPair<TTuple<FIntVector, TObjectKey<AActor>, FName>, FShooterNoiseEvent>& Pair : PendingNoises)
+	{
+		const FShooterNoiseEvent& Noise = Pair.Value;
+
+		UAISense_Hearing::ReportNoiseEvent(GetWorld(), Noise.Location, Noise.Loudness, Noise.Instigator.Get(), Noise.MaxRange, Noise.Tag);
+	}
+
+	PendingNoises.Reset();
+}
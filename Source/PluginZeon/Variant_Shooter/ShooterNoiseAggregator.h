@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterNoiseAggregator.generated.h"
+
+/**
+ *  A merged AI perception noise waiting to be reported
+ */
+struct FShooterNoiseEvent
+{
+	/** Location of the loudest merged noise */
+	FVector Location = FVector::ZeroVector;
+
+	/** Loudest merged loudness */
+	float Loudness = 0.0f;
+
+	/** Largest merged range */
+	float MaxRange = 0.0f;
+
+	/** Actor responsible for the noise */
+	TWeakObjectPtr<AActor> Instigator;
+
+	/** Noise tag */
+	FName Tag;
+};
+
+/**
+ *  World subsystem that merges AI perception noises from weapons and projectiles
+ *  Noises with the same instigator and tag within a small grid cell are merged into one event of the max loudness
+ *  The merged events are reported to the hearing sense once per window
+ */
+UCLASS(Config=Game)
+class PLUGINZEON_API UShooterNoiseAggregator : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Merged noises by grid cell, instigator and tag */
+	TMap<TTuple<FIntVector, TObjectKey<AActor>, FName>, FShooterNoiseEvent> PendingNoises;
+
+	/** Time left until the pending noises are reported */
+	float TimeUntilFlush = 0.0f;
+
+protected:
+
+	/** Size of the grid cells noises are merged in */
+	UPROPERTY(Config)
+	float CellSize = 200.0f;
+
+	/** Time window noises are merged over. Zero reports once per frame */
+	UPROPERTY(Config)
+	float MergeWindow = 0.1f;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Reports the merged noises when the window is over */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only merge noises in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Adds a noise to be merged and reported with the next batch */
+	void ReportNoise(AActor* Instigator, const FVector& Location, float Loudness, float MaxRange, FName Tag);
+
+protected:
+
+	/** Reports all pending noises to the hearing sense */
+	void FlushNoises();
+};
@@ -73,7 +73,11 @@ void AShooterPickup::OnOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 	// have we collided against a weapon holder?
 	if (IShooterWeaponHolder* WeaponHolder = Cast<IShooterWeaponHolder>(OtherActor))
 	{
-		WeaponHolder->AddWeaponClass(WeaponClass);
+		// leave the pickup in place if the holder can't take the weapon
+		if (!WeaponHolder->AddWeaponClass(WeaponClass))
+		{
+			return;
+		}
 
 		// hide this mesh
 		SetActorHiddenInGame(true);
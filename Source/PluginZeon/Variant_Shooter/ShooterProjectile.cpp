@@ -9,6 +9,12 @@
 #include "GameFramework/DamageType.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/Controller.h"
+#include "ShooterProjectilePool.h"
+#include "ShooterNoiseAggregator.h"
+#include "ShooterImpactBuffer.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "Engine/LatentActionManager.h"
 
 AShooterProjectile::AShooterProjectile()
 {
@@ -36,9 +42,20 @@ AShooterProjectile::AShooterProjectile()
 void AShooterProjectile::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// save the collision mode so it can be restored when the projectile is reused
+	DefaultCollisionEnabled = CollisionComponent->GetCollisionEnabled();
 	
 	// ignore the pawn that shot this projectile
-	CollisionComponent->IgnoreActorWhenMoving(GetInstigator(), true);
+	IgnoreInstigator();
+}
+
+void AShooterProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// clear the recycle timer
+	GetWorld()->GetTimerManager().ClearTimer(RecycleTimer);
 }
 
 void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Other, class UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit)
@@ -49,38 +66,211 @@ void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Ot
 		return;
 	}
 
+	// process the impact
+	HandleImpact(Other, OtherComp, GetVelocity(), Hit);
+}
+
+void AShooterProjectile::ProcessSimulatedHit(const FHitResult& Hit, const FVector& ImpactVelocity)
+{
+	// move to the impact point so noise and effects happen in the right place
+	SetActorLocation(Hit.Location, false, nullptr, ETeleportType::TeleportPhysics);
+
+	// process the impact as if this actor had flown there
+	HandleImpact(Hit.GetActor(), Hit.GetComponent(), ImpactVelocity, Hit);
+}
+
+void AShooterProjectile::HandleImpact(AActor* Other, UPrimitiveComponent* OtherComp, const FVector& ImpactVelocity, const FHitResult& Hit)
+{
 	bHit = true;
 
-	// make AI perception noise
-	MakeNoise(NoiseLoudness, GetInstigator(), GetActorLocation(), NoiseRange, NoiseTag);
+	// disable collision on the projectile
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
 	// have we hit a physics object?
-	if (OtherComp->IsSimulatingPhysics())
+	UPrimitiveComponent* PushedComponent = OtherComp && OtherComp->IsSimulatingPhysics() ? OtherComp : nullptr;
+
+	// have we hit a character? Ignore the owner of this projectile
+	ACharacter* HitCharacter = Cast<ACharacter>(Other);
+
+	if (HitCharacter == GetOwner())
 	{
-		// give some physics impulse to the object
-		OtherComp->AddImpulseAtLocation(GetVelocity() * PhysicsForce, Hit.ImpactPoint);
+		HitCharacter = nullptr;
 	}
 
-	// have we hit a character?
-	if (ACharacter* HitCharacter = Cast<ACharacter>(Other))
+	// record the hit so it's processed after physics together with the rest of the frame's hits
+	if (UShooterImpactBuffer* ImpactBuffer = GetWorld()->GetSubsystem<UShooterImpactBuffer>())
 	{
-		// ignore the owner of this projectile
-		if (HitCharacter != GetOwner())
-		{
-			// damage the hit character
-			DamageCharacter(HitCharacter, Hit);
-		}
+		FShooterBufferedImpact Impact;
+		Impact.Projectile = this;
+		Impact.Hit = Hit;
+		Impact.DamagedActor = HitCharacter;
+		Impact.Damage = HitDamage;
+		Impact.DamageType = HitDamageType;
+		Impact.InstigatorController = GetInstigatorController();
+		Impact.PushedComponent = PushedComponent;
+		Impact.Impulse = ImpactVelocity * PhysicsForce;
+
+		ImpactBuffer->AddImpact(MoveTemp(Impact));
+
+		// hold still at the impact until the effects play, so they don't follow a bounce
+		ProjectileMovement->StopMovementImmediately();
+		ProjectileMovement->Deactivate();
+
+		// don't let the flight lifetime recycle us before the effects have played
+		GetWorld()->GetTimerManager().ClearTimer(RecycleTimer);
+		return;
 	}
 
-	// disable collision on the projectile
-	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	// give some physics impulse to the object
+	if (PushedComponent)
+	{
+		PushedComponent->AddImpulseAtLocation(ImpactVelocity * PhysicsForce, Hit.ImpactPoint);
+	}
+
+	// damage the hit character
+	if (HitCharacter)
+	{
+		DamageCharacter(HitCharacter, HitDamage, Hit);
+	}
+
+	PlayImpactEffects(Hit);
+}
+
+void AShooterProjectile::PlayImpactEffects(const FHitResult& Hit)
+{
+	// make AI perception noise at the impact. Merge it with other nearby impacts if possible
+	if (UShooterNoiseAggregator* NoiseAggregator = GetWorld()->GetSubsystem<UShooterNoiseAggregator>())
+	{
+		NoiseAggregator->ReportNoise(GetInstigator(), Hit.ImpactPoint, NoiseLoudness, NoiseRange, NoiseTag);
+
+	} else {
+
+		MakeNoise(NoiseLoudness, GetInstigator(), Hit.ImpactPoint, NoiseRange, NoiseTag);
+	}
 
 	// pass control to BP for any extra effects
 	BP_OnProjectileHit(Hit);
+
+	// give the hit effects some time before returning to the pool
+	if (bPooled)
+	{
+		GetWorld()->GetTimerManager().SetTimer(RecycleTimer, this, &AShooterProjectile::ReturnToPool, PooledHitRecycleDelay, false);
+	}
 }
 
-void AShooterProjectile::DamageCharacter(ACharacter* HitCharacter, const FHitResult& Hit)
+void AShooterProjectile::DamageCharacter(ACharacter* HitCharacter, float Damage, const FHitResult& Hit)
 {
 	// apply damage to the character
-	UGameplayStatics::ApplyDamage(HitCharacter, HitDamage, GetInstigator()->GetController(), this, HitDamageType);
+	UGameplayStatics::ApplyDamage(HitCharacter, Damage, GetInstigatorController(), this, HitDamageType);
+}
+
+void AShooterProjectile::IgnoreInstigator()
+{
+	if (APawn* ProjectileInstigator = GetInstigator())
+	{
+		CollisionComponent->IgnoreActorWhenMoving(ProjectileInstigator, true);
+	}
+}
+
+void AShooterProjectile::K2_DestroyActor()
+{
+	if (bPooled)
+	{
+		// hit BPs destroy the projectile once their effects are done, so recycle it instead
+		ReturnToPool();
+
+	} else {
+
+		Super::K2_DestroyActor();
+	}
+}
+
+void AShooterProjectile::LifeSpanExpired()
+{
+	if (bPooled)
+	{
+		ReturnToPool();
+
+	} else {
+
+		Super::LifeSpanExpired();
+	}
+}
+
+void AShooterProjectile::ReturnToPool()
+{
+	if (UShooterProjectilePool* Pool = GetWorld()->GetSubsystem<UShooterProjectilePool>())
+	{
+		Pool->ReleaseProjectile(this);
+
+	} else {
+
+		// no pool to return to, so just destroy the projectile
+		Destroy();
+	}
+}
+
+void AShooterProjectile::ActivateFromPool(const FTransform& SpawnTransform, AActor* NewOwner, APawn* NewInstigator, bool bLaunch)
+{
+	// clear any state left over from the previous shot
+	GetWorld()->GetTimerManager().ClearTimer(RecycleTimer);
+	SetLifeSpan(0.0f);
+	bHit = false;
+	bInPool = false;
+
+	// take on the new shooter
+	SetOwner(NewOwner);
+	SetInstigator(NewInstigator);
+
+	CollisionComponent->ClearMoveIgnoreActors();
+	IgnoreInstigator();
+
+	// move to the spawn transform without sweeping
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// restore visibility and ticking
+	SetActorHiddenInGame(false);
+	SetActorTickEnabled(true);
+
+	// the projectile is only needed to play effects, so keep it still and without collision
+	if (!bLaunch)
+	{
+		CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		ProjectileMovement->StopMovementImmediately();
+		ProjectileMovement->Deactivate();
+		return;
+	}
+
+	// restore collision
+	CollisionComponent->SetCollisionEnabled(DefaultCollisionEnabled);
+
+	// relaunch the projectile along its new facing
+	ProjectileMovement->SetUpdatedComponent(CollisionComponent);
+	ProjectileMovement->Velocity = SpawnTransform.GetRotation().Vector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->Activate(true);
+	ProjectileMovement->UpdateComponentVelocity();
+
+	// schedule the return to the pool at the end of the lifetime
+	GetWorld()->GetTimerManager().SetTimer(RecycleTimer, this, &AShooterProjectile::ReturnToPool, PooledLifeSpan, false);
+}
+
+void AShooterProjectile::DeactivateToPool()
+{
+	bInPool = true;
+
+	// the pool manages the lifetime from now on
+	GetWorld()->GetTimerManager().ClearTimer(RecycleTimer);
+	SetLifeSpan(0.0f);
+
+	// drop BP delays from the previous shot so they can't act on the next one
+	GetWorld()->GetLatentActionManager().RemoveActionsForObject(this);
+
+	// stop moving
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	// hide and disable the projectile
+	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetActorHiddenInGame(true);
+	SetActorTickEnabled(false);
 }
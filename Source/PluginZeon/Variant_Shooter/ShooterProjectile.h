@@ -9,6 +9,8 @@
 class USphereComponent;
 class UProjectileMovementComponent;
 class ACharacter;
+class APawn;
+class UStaticMesh;
 
 /**
  *  Simple projectile class for a first person shooter game
@@ -55,6 +57,30 @@ protected:
 	/** If true, this projectile has already hit another surface */
 	bool bHit = false;
 
+	/** Time a pooled projectile stays in flight before returning to the pool */
+	UPROPERTY(EditAnywhere, Category="Pool")
+	float PooledLifeSpan = 5.0f;
+
+	/** Time a pooled projectile waits after a hit before returning to the pool. Lets hit effects play out */
+	UPROPERTY(EditAnywhere, Category="Pool")
+	float PooledHitRecycleDelay = 2.0f;
+
+	/** Mesh drawn as a tracer while this projectile flies as a simulated row. Simulated rows are invisible without it */
+	UPROPERTY(EditAnywhere, Category="Simulation")
+	TObjectPtr<UStaticMesh> SimulatedTracerMesh;
+
+	/** If true, this projectile is owned by the projectile pool and will be recycled instead of destroyed */
+	bool bPooled = false;
+
+	/** If true, this projectile is currently parked in the pool */
+	bool bInPool = false;
+
+	/** Collision mode to restore when the projectile is reused */
+	TEnumAsByte<ECollisionEnabled::Type> DefaultCollisionEnabled = ECollisionEnabled::QueryAndPhysics;
+
+	/** Timer to return a pooled projectile to the pool */
+	FTimerHandle RecycleTimer;
+
 public:	
 
 	/** Constructor */
@@ -65,16 +91,69 @@ protected:
 	/** Gameplay initialization */
 	virtual void BeginPlay() override;
 
+	/** Gameplay cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** Handles collision */
 	virtual void NotifyHit(class UPrimitiveComponent* MyComp, AActor* Other, class UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit) override;
 
-protected:
+	/** Handles the physics, damage, noise and effects of a hit. Deferred to the impact buffer if available */
+	void HandleImpact(AActor* Other, UPrimitiveComponent* OtherComp, const FVector& ImpactVelocity, const FHitResult& Hit);
 
-	/** Apply damage to a hit character */
+public:
+
+	/** Apply damage to a hit character. Buffered hits of this projectile class on the same character arrive here merged into a single call */
 	UFUNCTION(BlueprintCallable, Category="Projectile")
-	virtual void DamageCharacter(ACharacter* HitCharacter, const FHitResult& Hit);
+	virtual void DamageCharacter(ACharacter* HitCharacter, float Damage, const FHitResult& Hit);
+
+protected:
 
 	/** Passes control to Blueprint to implement any effects on hit */
 	UFUNCTION(BlueprintImplementableEvent, Category="Projectile", meta=(DisplayName = "On Projectile Hit"))
 	void BP_OnProjectileHit(const FHitResult& Hit);
+
+	/** Ignores the pawn that shot this projectile while moving */
+	void IgnoreInstigator();
+
+	/** Pooled projectiles go back to the pool when Blueprint destroys them */
+	virtual void K2_DestroyActor() override;
+
+	/** Pooled projectiles go back to the pool when their life span runs out */
+	virtual void LifeSpanExpired() override;
+
+public:
+
+	/** Returns a pooled projectile to the pool, or destroys it if there's no pool */
+	UFUNCTION(BlueprintCallable, Category="Projectile")
+	void ReturnToPool();
+
+	/** Resets the projectile state and moves it to the given transform. Unless bLaunch is false, it also enables collision and flight */
+	void ActivateFromPool(const FTransform& SpawnTransform, AActor* NewOwner, APawn* NewInstigator, bool bLaunch = true);
+
+	/** Processes a hit found by the simulated projectile manager, reusing the regular hit logic */
+	void ProcessSimulatedHit(const FHitResult& Hit, const FVector& ImpactVelocity);
+
+	/** Makes the hit noise, plays the hit effects and schedules the return to the pool */
+	void PlayImpactEffects(const FHitResult& Hit);
+
+	/** Stops, hides and disables the projectile while it waits in the pool */
+	void DeactivateToPool();
+
+	/** Flags this projectile as owned by the projectile pool */
+	void SetPooled(bool bInPooled) { bPooled = bInPooled; }
+
+	/** Returns true if this projectile is currently parked in the pool */
+	bool IsInPool() const { return bInPool; }
+
+	/** Returns the flight time before a pooled or simulated projectile expires */
+	float GetPooledLifeSpan() const { return PooledLifeSpan; }
+
+	/** Returns the tracer mesh for simulated flight */
+	UStaticMesh* GetSimulatedTracerMesh() const { return SimulatedTracerMesh; }
+
+	/** Returns the collision component */
+	USphereComponent* GetCollisionComponent() const { return CollisionComponent; }
+
+	/** Returns the projectile movement component */
+	UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
 };
@@ -0,0 +1,343 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterProjectileManager.h"
+#include "ShooterProjectile.h"
+#include "ShooterProjectilePool.h"
+#include "Components/SphereComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "Async/ParallelFor.h"
+#include "Utility/PauseManager.h"
+
+void UShooterProjectileManager::Deinitialize()
+{
+	// drop all projectiles in flight
+	Positions.Empty();
+	Velocities.Empty();
+	RemainingLifeSpans.Empty();
+	TypeIndices.Empty();
+	IgnoredActorIds.Empty();
+	Owners.Empty();
+	Instigators.Empty();
+
+	PendingHitscanShots.Empty();
+
+	// remove the tracers
+	for (FShooterSimulatedProjectileType& Type : ProjectileTypes)
+	{
+		if (Type.Tracers)
+		{
+			Type.Tracers->DestroyComponent();
+		}
+	}
+
+	ProjectileTypes.Empty();
+	ProjectileTypeIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterProjectileManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// resolve any hitscan shots traced since last frame
+	ProcessHitscanResults();
+
+	// advance the projectiles in flight
+	TickSimulatedProjectiles(DeltaTime);
+
+	// draw them where they ended up
+	UpdateTracers();
+}
+
+void UShooterProjectileManager::TickSimulatedProjectiles(float DeltaTime)
+{
+	const int32 NumProjectiles = Positions.Num();
+
+	if (NumProjectiles == 0)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+
+	// hold projectiles in place while their pause scope is active
+	if (FPauseManager::IsScopePaused(World, EPauseScope::Projectiles))
+	{
+		return;
+	}
+
+	// integrate all projectiles in one pass
+	const float GravityZ = World->GetGravityZ();
+
+	NextPositions.SetNumUninitialized(NumProjectiles, EAllowShrinking::No);
+
+	for (int32 Index = 0; Index < NumProjectiles; ++Index)
+	{
+		const FVector Acceleration(0.0f, 0.0f, GravityZ * ProjectileTypes[TypeIndices[Index]].GravityScale);
+
+		NextPositions[Index] = Positions[Index] + (Velocities[Index] * DeltaTime) + (Acceleration * (0.5f * DeltaTime * DeltaTime));
+		Velocities[Index] += Acceleration * DeltaTime;
+		RemainingLifeSpans[Index] -= DeltaTime;
+	}
+
+	// sweep all projectiles along their step as a single batch
+	// small batches aren't worth the task overhead, so keep them on the game thread
+	constexpr int32 MinParallelSweepCount = 32;
+
+	SweepHits.SetNum(NumProjectiles, EAllowShrinking::No);
+	SweepBlocked.SetNumUninitialized(NumProjectiles, EAllowShrinking::No);
+
+	ParallelFor(NumProjectiles, [this, World](int32 Index)
+	{
+		const FShooterSimulatedProjectileType& Type = ProjectileTypes[TypeIndices[Index]];
+
+		// ignore the pawn that shot this projectile. Uses the actor id so no UObjects are touched off the game thread
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterProjectileSweep), false);
+		QueryParams.AddIgnoredActor(IgnoredActorIds[Index]);
+
+		SweepBlocked[Index] = World->SweepSingleByChannel(SweepHits[Index], Positions[Index], NextPositions[Index], FQuat::Identity, Type.CollisionChannel, FCollisionShape::MakeSphere(Type.Radius), QueryParams, Type.ResponseParams);
+
+	}, NumProjectiles < MinParallelSweepCount ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	// resolve the results back to front so rows swapped in from the end have already been processed
+	for (int32 Index = NumProjectiles - 1; Index >= 0; --Index)
+	{
+		if (SweepBlocked[Index])
+		{
+			// hand the hit over to the regular projectile hit logic
+			ProcessHit(TypeIndices[Index], SweepHits[Index], Velocities[Index], Owners[Index].Get(), Instigators[Index].Get());
+			RemoveProjectileAtSwap(Index);
+
+		} else if (RemainingLifeSpans[Index] <= 0.0f) {
+
+			// the projectile expired without hitting anything
+			RemoveProjectileAtSwap(Index);
+
+		} else {
+
+			// commit the step
+			Positions[Index] = NextPositions[Index];
+		}
+	}
+}
+
+void UShooterProjectileManager::UpdateTracers()
+{
+	for (int32 TypeIndex = 0; TypeIndex < ProjectileTypes.Num(); ++TypeIndex)
+	{
+		UInstancedStaticMeshComponent* Tracers = ProjectileTypes[TypeIndex].Tracers;
+
+		if (!Tracers)
+		{
+			continue;
+		}
+
+		// gather the rows of this type, facing along their velocity
+		TracerTransforms.Reset();
+
+		for (int32 Index = 0; Index < Positions.Num(); ++Index)
+		{
+			if (TypeIndices[Index] == TypeIndex)
+			{
+				TracerTransforms.Emplace(Velocities[Index].Rotation(), Positions[Index]);
+			}
+		}
+
+		const int32 NumInstances = Tracers->GetInstanceCount();
+
+		if (NumInstances == 0 && TracerTransforms.Num() == 0)
+		{
+			continue;
+		}
+
+		// match the instance count to the rows in flight
+		if (TracerTransforms.Num() == 0)
+		{
+			Tracers->ClearInstances();
+			continue;
+		}
+
+		if (NumInstances > TracerTransforms.Num())
+		{
+			TArray<int32> ExtraInstances;
+
+			for (int32 Index = TracerTransforms.Num(); Index < NumInstances; ++Index)
+			{
+				ExtraInstances.Add(Index);
+			}
+
+			Tracers->RemoveInstances(ExtraInstances);
+		}
+
+		for (int32 Index = NumInstances; Index < TracerTransforms.Num(); ++Index)
+		{
+			Tracers->AddInstance(TracerTransforms[Index], true);
+		}
+
+		// move all instances in one batch
+		Tracers->BatchUpdateInstancesTransforms(0, TracerTransforms, true, true, true);
+	}
+}
+
+void UShooterProjectileManager::ProcessHitscanResults()
+{
+	UWorld* World = GetWorld();
+
+	for (int32 Index = PendingHitscanShots.Num() - 1; Index >= 0; --Index)
+	{
+		// copy the shot, since hit logic may queue new shots
+		const FShooterHitscanShot Shot = PendingHitscanShots[Index];
+
+		FTraceDatum TraceData;
+
+		if (World->QueryTraceData(Shot.TraceHandle, TraceData))
+		{
+			// process the first blocking hit, if any
+			if (TraceData.OutHits.Num() > 0 && TraceData.OutHits[0].bBlockingHit)
+			{
+				ProcessHit(Shot.TypeIndex, TraceData.OutHits[0], Shot.ImpactVelocity, Shot.Owner.Get(), Shot.Instigator.Get());
+			}
+
+			PendingHitscanShots.RemoveAtSwap(Index, EAllowShrinking::No);
+
+		} else if (!World->IsTraceHandleValid(Shot.TraceHandle, false)) {
+
+			// the trace results expired before we could read them
+			PendingHitscanShots.RemoveAtSwap(Index, EAllowShrinking::No);
+		}
+	}
+}
+
+TStatId UShooterProjectileManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterProjectileManager, STATGROUP_Tickables);
+}
+
+bool UShooterProjectileManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterProjectileManager::SpawnProjectile(const TSubclassOf<AShooterProjectile>& ProjectileClass, const FTransform& SpawnTransform, AActor* NewOwner, APawn* NewInstigator)
+{
+	const int32 TypeIndex = FindOrAddProjectileType(ProjectileClass);
+
+	if (TypeIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FShooterSimulatedProjectileType& Type = ProjectileTypes[TypeIndex];
+
+	// add the projectile row
+	Positions.Add(SpawnTransform.GetLocation());
+	Velocities.Add(SpawnTransform.GetRotation().Vector() * Type.Speed);
+	RemainingLifeSpans.Add(Type.LifeSpan);
+	TypeIndices.Add(TypeIndex);
+	IgnoredActorIds.Add(NewInstigator ? NewInstigator->GetUniqueID() : 0);
+	Owners.Add(NewOwner);
+	Instigators.Add(NewInstigator);
+}
+
+void UShooterProjectileManager::FireHitscanShot(const TSubclassOf<AShooterProjectile>& ProjectileClass, const FTransform& SpawnTransform, float Range, AActor* NewOwner, APawn* NewInstigator)
+{
+	const int32 TypeIndex = FindOrAddProjectileType(ProjectileClass);
+
+	if (TypeIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FShooterSimulatedProjectileType& Type = ProjectileTypes[TypeIndex];
+
+	const FVector Start = SpawnTransform.GetLocation();
+	const FVector Direction = SpawnTransform.GetRotation().Vector();
+
+	// ignore the pawn that fired the shot
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterHitscanTrace), false);
+	QueryParams.AddIgnoredActor(NewInstigator);
+
+	// queue the trace. The engine runs all async traces requested this frame as one batch
+	FShooterHitscanShot& Shot = PendingHitscanShots.AddDefaulted_GetRef();
+	Shot.TraceHandle = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, Start + (Direction * Range), Type.CollisionChannel, QueryParams, Type.ResponseParams);
+	Shot.TypeIndex = TypeIndex;
+	Shot.ImpactVelocity = Direction * Type.Speed;
+	Shot.Owner = NewOwner;
+	Shot.Instigator = NewInstigator;
+}
+
+int32 UShooterProjectileManager::FindOrAddProjectileType(const TSubclassOf<AShooterProjectile>& ProjectileClass)
+{
+	if (!ProjectileClass)
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* FoundIndex = ProjectileTypeIndices.Find(ProjectileClass.Get()))
+	{
+		return *FoundIndex;
+	}
+
+	// read the flight and collision parameters from the class defaults
+	const AShooterProjectile* Defaults = ProjectileClass->GetDefaultObject<AShooterProjectile>();
+	const USphereComponent* Collision = Defaults->GetCollisionComponent();
+	const UProjectileMovementComponent* Movement = Defaults->GetProjectileMovement();
+
+	FShooterSimulatedProjectileType& Type = ProjectileTypes.AddDefaulted_GetRef();
+	Type.ProjectileClass = ProjectileClass;
+	Type.Radius = Collision->GetScaledSphereRadius();
+	Type.Speed = Movement->InitialSpeed > 0.0f ? Movement->InitialSpeed : Movement->MaxSpeed;
+	Type.GravityScale = Movement->ProjectileGravityScale;
+	Type.LifeSpan = Defaults->GetPooledLifeSpan();
+	Type.CollisionChannel = Collision->GetCollisionObjectType();
+	Type.ResponseParams = FCollisionResponseParams(Collision->GetCollisionResponseToChannels());
+
+	// draw the rows in flight as instances of a tracer mesh. Types without one fly unseen
+	if (UStaticMesh* TracerMesh = Defaults->GetSimulatedTracerMesh())
+	{
+		Type.Tracers = NewObject<UInstancedStaticMeshComponent>(this);
+		Type.Tracers->SetStaticMesh(TracerMesh);
+		Type.Tracers->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Type.Tracers->SetCastShadow(false);
+		Type.Tracers->SetCanEverAffectNavigation(false);
+		Type.Tracers->SetMobility(EComponentMobility::Movable);
+		Type.Tracers->RegisterComponentWithWorld(GetWorld());
+	}
+
+	return ProjectileTypeIndices.Add(ProjectileClass.Get(), ProjectileTypes.Num() - 1);
+}
+
+void UShooterProjectileManager::ProcessHit(int32 TypeIndex, const FHitResult& Hit, const FVector& ImpactVelocity, AActor* HitOwner, APawn* HitInstigator)
+{
+	UShooterProjectilePool* Pool = GetWorld()->GetSubsystem<UShooterProjectilePool>();
+
+	if (!Pool)
+	{
+		return;
+	}
+
+	// bring in a projectile actor at the impact point, facing along the flight direction
+	const FTransform ImpactTransform(ImpactVelocity.Rotation(), Hit.Location);
+
+	if (AShooterProjectile* Projectile = Pool->AcquireProjectile(ProjectileTypes[TypeIndex].ProjectileClass, ImpactTransform, HitOwner, HitInstigator, false))
+	{
+		// run the regular hit logic and effects
+		Projectile->ProcessSimulatedHit(Hit, ImpactVelocity);
+	}
+}
+
+void UShooterProjectileManager::RemoveProjectileAtSwap(int32 Index)
+{
+	Positions.RemoveAtSwap(Index, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, EAllowShrinking::No);
+	RemainingLifeSpans.RemoveAtSwap(Index, EAllowShrinking::No);
+	TypeIndices.RemoveAtSwap(Index, EAllowShrinking::No);
+	IgnoredActorIds.RemoveAtSwap(Index, EAllowShrinking::No);
+	Owners.RemoveAtSwap(Index, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(Index, EAllowShrinking::No);
+}
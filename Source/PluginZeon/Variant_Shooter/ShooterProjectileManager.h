@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "ShooterProjectileManager.generated.h"
+
+class AShooterProjectile;
+class APawn;
+class UInstancedStaticMeshComponent;
+
+/**
+ *  Collision and flight parameters shared by all simulated projectiles of a class
+ *  Read once from the projectile class defaults
+ */
+USTRUCT()
+struct FShooterSimulatedProjectileType
+{
+	GENERATED_BODY()
+
+	/** Projectile class used to materialize impacts */
+	UPROPERTY()
+	TSubclassOf<AShooterProjectile> ProjectileClass;
+
+	/** Radius of the collision sphere */
+	float Radius = 0.0f;
+
+	/** Initial flight speed */
+	float Speed = 0.0f;
+
+	/** Gravity scale of the projectile movement */
+	float GravityScale = 1.0f;
+
+	/** Flight time before the projectile expires */
+	float LifeSpan = 0.0f;
+
+	/** Collision channel to sweep with */
+	TEnumAsByte<ECollisionChannel> CollisionChannel = ECC_WorldDynamic;
+
+	/** Collision responses of the projectile */
+	FCollisionResponseParams ResponseParams;
+
+	/** Draws one tracer instance per row in flight. Null if the class has no tracer mesh */
+	UPROPERTY()
+	TObjectPtr<UInstancedStaticMeshComponent> Tracers;
+};
+
+/**
+ *  A hitscan shot waiting on its async trace
+ */
+struct FShooterHitscanShot
+{
+	/** Handle of the async trace */
+	FTraceHandle TraceHandle;
+
+	/** Projectile type used to resolve the hit */
+	int32 TypeIndex = INDEX_NONE;
+
+	/** Velocity to use for the impact physics */
+	FVector ImpactVelocity = FVector::ZeroVector;
+
+	/** Shooter of the shot */
+	TWeakObjectPtr<AActor> Owner;
+	TWeakObjectPtr<APawn> Instigator;
+};
+
+/**
+ *  World subsystem that simulates projectiles as plain data instead of one actor per bullet
+ *  Bullets are rows in packed arrays that are integrated and swept in a single batch each frame
+ *  Also resolves hitscan shots through async line traces, which the engine runs as one parallel batch per frame
+ *  A pooled projectile actor is only brought in at the impact point to run the regular hit logic and effects
+ *  Rows in flight are drawn as instances of the projectile class's tracer mesh, if it has one
+ */
+UCLASS()
+class PLUGINZEON_API UShooterProjectileManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Projectile types by index */
+	UPROPERTY()
+	TArray<FShooterSimulatedProjectileType> ProjectileTypes;
+
+	/** Lookup from projectile class to its type index */
+	TMap<UClass*, int32> ProjectileTypeIndices;
+
+	/** Simulated projectile rows. All arrays share the same index */
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> RemainingLifeSpans;
+	TArray<int32> TypeIndices;
+	TArray<uint32> IgnoredActorIds;
+	TArray<TWeakObjectPtr<AActor>> Owners;
+	TArray<TWeakObjectPtr<APawn>> Instigators;
+
+	/** Hitscan shots waiting on their trace results */
+	TArray<FShooterHitscanShot> PendingHitscanShots;
+
+	/** Per frame scratch buffers for the collision batch */
+	TArray<FVector> NextPositions;
+	TArray<FHitResult> SweepHits;
+	TArray<bool> SweepBlocked;
+
+	/** Per frame scratch buffer for the tracer transforms */
+	TArray<FTransform> TracerTransforms;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Integrates and sweeps all simulated projectiles */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only simulate projectiles in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Adds a simulated projectile of the given class flying along the spawn transform's facing */
+	void SpawnProjectile(const TSubclassOf<AShooterProjectile>& ProjectileClass, const FTransform& SpawnTransform, AActor* NewOwner, APawn* NewInstigator);
+
+	/** Queues an instant shot along the spawn transform's facing. The hit is resolved once the async trace completes */
+	void FireHitscanShot(const TSubclassOf<AShooterProjectile>& ProjectileClass, const FTransform& SpawnTransform, float Range, AActor* NewOwner, APawn* NewInstigator);
+
+	/** Returns the number of projectiles currently in flight */
+	UFUNCTION(BlueprintPure, Category="Projectile Manager")
+	int32 GetNumSimulatedProjectiles() const { return Positions.Num(); }
+
+protected:
+
+	/** Returns the type index for the given projectile class, registering it if needed */
+	int32 FindOrAddProjectileType(const TSubclassOf<AShooterProjectile>& ProjectileClass);
+
+	/** Integrates and sweeps the simulated projectile rows */
+	void TickSimulatedProjectiles(float DeltaTime);
+
+	/** Moves the tracer instances of each projectile type to its rows in flight */
+	void UpdateTracers();
+
+	/** Resolves the hitscan shots whose traces have completed */
+	void ProcessHitscanResults();
+
+	/** Hands a hit over to a pooled projectile actor so it runs the regular hit logic */
+	void ProcessHit(int32 TypeIndex, const FHitResult& Hit, const FVector& ImpactVelocity, AActor* HitOwner, APawn* HitInstigator);
+
+	/** Removes a row by swapping the last row into its place */
+	void RemoveProjectileAtSwap(int32 Index);
+};
@@ -0,0 +1,152 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterProjectilePool.h"
+#include "ShooterProjectile.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+void UShooterProjectilePool::Deinitialize()
+{
+	// the actors themselves are cleaned up with the world
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterProjectilePool::PrewarmProjectiles(const TSubclassOf<AShooterProjectile>& ProjectileClass, int32 Count)
+{
+	if (!ProjectileClass)
+	{
+		return;
+	}
+
+	FShooterProjectilePoolEntry& Pool = Pools.FindOrAdd(ProjectileClass);
+
+	// only top up to the requested amount so multiple weapons sharing a class don't over allocate
+	while (Pool.FreeProjectiles.Num() < Count)
+	{
+		AShooterProjectile* Projectile = SpawnPooledProjectile(ProjectileClass, FTransform::Identity, nullptr, nullptr);
+
+		if (!Projectile)
+		{
+			return;
+		}
+
+		// park the new projectile in the pool
+		Projectile->DeactivateToPool();
+		Pool.FreeProjectiles.Add(Projectile);
+		++Pool.Stats.NumFree;
+	}
+}
+
+AShooterProjectile* UShooterProjectilePool::AcquireProjectile(const TSubclassOf<AShooterProjectile>& ProjectileClass, const FTransform& SpawnTransform, AActor* NewOwner, APawn* NewInstigator, bool bLaunch)
+{
+	if (!ProjectileClass)
+	{
+		return nullptr;
+	}
+
+	FShooterProjectilePoolEntry& Pool = Pools.FindOrAdd(ProjectileClass);
+
+	AShooterProjectile* Projectile = nullptr;
+
+	// reuse the most recently released projectile
+	while (!Projectile && Pool.FreeProjectiles.Num() > 0)
+	{
+		Projectile = Pool.FreeProjectiles.Pop(EAllowShrinking::No);
+		--Pool.Stats.NumFree;
+
+		// skip any projectile that was destroyed while parked
+		if (!IsValid(Projectile))
+		{
+			Projectile = nullptr;
+			continue;
+		}
+
+		++Pool.Stats.NumReused;
+	}
+
+	// the pool is empty, so grow it
+	if (!Projectile)
+	{
+		Projectile = SpawnPooledProjectile(ProjectileClass, SpawnTransform, NewOwner, NewInstigator);
+
+		if (!Projectile)
+		{
+			return nullptr;
+		}
+	}
+
+	// reset the projectile for the new shot
+	Projectile->ActivateFromPool(SpawnTransform, NewOwner, NewInstigator, bLaunch);
+	++Pool.Stats.NumActive;
+
+	return Projectile;
+}
+
+void UShooterProjectilePool::ReleaseProjectile(AShooterProjectile* Projectile)
+{
+	// ignore invalid or already released projectiles
+	if (!IsValid(Projectile) || Projectile->IsInPool())
+	{
+		return;
+	}
+
+	FShooterProjectilePoolEntry& Pool = Pools.FindOrAdd(Projectile->GetClass());
+
+	// park the projectile
+	Projectile->DeactivateToPool();
+	Pool.FreeProjectiles.Add(Projectile);
+
+	--Pool.Stats.NumActive;
+	++Pool.Stats.NumFree;
+}
+
+FShooterProjectilePoolStats UShooterProjectilePool::GetPoolStats(TSubclassOf<AShooterProjectile> ProjectileClass) const
+{
+	const FShooterProjectilePoolEntry* Pool = Pools.Find(ProjectileClass);
+	return Pool ? Pool->Stats : FShooterProjectilePoolStats();
+}
+
+AShooterProjectile* UShooterProjectilePool::SpawnPooledProjectile(const TSubclassOf<AShooterProjectile>& ProjectileClass, const FTransform& SpawnTransform, AActor* NewOwner, APawn* NewInstigator)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::OverrideRootScale;
+	SpawnParams.Owner = NewOwner;
+	SpawnParams.Instigator = NewInstigator;
+
+	AShooterProjectile* Projectile = GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, SpawnTransform, SpawnParams);
+
+	if (Projectile)
+	{
+		// flag the projectile so it comes back to us instead of being destroyed
+		Projectile->SetPooled(true);
+
+		// keep the counters honest if something else destroys the projectile
+		Projectile->OnDestroyed.AddDynamic(this, &UShooterProjectilePool::OnPooledProjectileDestroyed);
+
+		++Pools.FindOrAdd(ProjectileClass).Stats.NumSpawned;
+	}
+
+	return Projectile;
+}
+
+void UShooterProjectilePool::OnPooledProjectileDestroyed(AActor* DestroyedActor)
+{
+	AShooterProjectile* Projectile = Cast<AShooterProjectile>(DestroyedActor);
+
+	if (FShooterProjectilePoolEntry* Pool = Projectile ? Pools.Find(Projectile->GetClass()) : nullptr)
+	{
+		// was the projectile parked or in flight?
+		if (Pool->FreeProjectiles.Remove(Projectile) > 0)
+		{
+			--Pool->Stats.NumFree;
+		}
+		else
+		{
+			--Pool->Stats.NumActive;
+		}
+	}
+}
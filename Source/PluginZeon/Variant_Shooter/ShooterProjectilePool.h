@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterProjectilePool.generated.h"
+
+class AShooterProjectile;
+class APawn;
+
+/**
+ *  Usage counters for a single projectile class pool
+ */
+USTRUCT(BlueprintType)
+struct FShooterProjectilePoolStats
+{
+	GENERATED_BODY()
+
+	/** Projectiles waiting in the pool */
+	UPROPERTY(BlueprintReadOnly, Category="Pool")
+	int32 NumFree = 0;
+
+	/** Projectiles currently in flight or playing their hit effects */
+	UPROPERTY(BlueprintReadOnly, Category="Pool")
+	int32 NumActive = 0;
+
+	/** Total projectile actors spawned by the pool */
+	UPROPERTY(BlueprintReadOnly, Category="Pool")
+	int32 NumSpawned = 0;
+
+	/** Total times a pooled projectile was reused instead of spawned */
+	UPROPERTY(BlueprintReadOnly, Category="Pool")
+	int32 NumReused = 0;
+};
+
+/**
+ *  Pooled projectiles for a single projectile class
+ */
+USTRUCT()
+struct FShooterProjectilePoolEntry
+{
+	GENERATED_BODY()
+
+	/** Inactive projectiles ready to be reused */
+	UPROPERTY()
+	TArray<TObjectPtr<AShooterProjectile>> FreeProjectiles;
+
+	/** Usage counters */
+	FShooterProjectilePoolStats Stats;
+};
+
+/**
+ *  World subsystem that recycles shooter projectiles
+ *  Keeps a pool of hidden projectile actors per class so firing only resets an existing actor
+ *  Projectiles return to the pool on hit or when their lifetime expires
+ */
+UCLASS()
+class PLUGINZEON_API UShooterProjectilePool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Pools by projectile class */
+	UPROPERTY()
+	TMap<TSubclassOf<AShooterProjectile>, FShooterProjectilePoolEntry> Pools;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+public:
+
+	/** Spawns inactive projectiles of the given class until the pool holds at least Count of them */
+	void PrewarmProjectiles(const TSubclassOf<AShooterProjectile>& ProjectileClass, int32 Count);
+
+	/** Returns an active projectile of the given class, reusing a pooled one if available. If bLaunch is false, the projectile is placed without collision or flight */
+	AShooterProjectile* AcquireProjectile(const TSubclassOf<AShooterProjectile>& ProjectileClass, const FTransform& SpawnTransform, AActor* NewOwner, APawn* NewInstigator, bool bLaunch = true);
+
+	/** Deactivates the projectile and returns it to its pool */
+	void ReleaseProjectile(AShooterProjectile* Projectile);
+
+	/** Returns the usage counters for the given projectile class */
+	UFUNCTION(BlueprintCallable, Category="Projectile Pool")
+	FShooterProjectilePoolStats GetPoolStats(TSubclassOf<AShooterProjectile> ProjectileClass) const;
+
+protected:
+
+	/** Spawns a new projectile actor owned by the pool */
+	AShooterProjectile* SpawnPooledProjectile(const TSubclassOf<AShooterProjectile>& ProjectileClass, const FTransform& SpawnTransform, AActor* NewOwner, APawn* NewInstigator);
+
+	/** Drops a pooled projectile that was destroyed by something else */
+	UFUNCTION()
+	void OnPooledProjectileDestroyed(AActor* DestroyedActor);
+};
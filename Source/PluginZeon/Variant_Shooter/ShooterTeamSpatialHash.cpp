@@ -0,0 +1,230 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterTeamSpatialHash.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+void UShooterTeamSpatialHash::Deinitialize()
+{
+	RegisteredTeams.Empty();
+	RegisteredActors.Empty();
+
+	Actors.Empty();
+	Positions.Empty();
+	Teams.Empty();
+	Cells.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterTeamSpatialHash::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// drop actors that went away without unregistering
+	const int32 NumRegistered = RegisteredActors.Num();
+
+	RegisteredActors.RemoveAllSwap([](const TWeakObjectPtr<AActor>& Actor) { return !Actor.IsValid(); }, EAllowShrinking::No);
+
+	if (RegisteredActors.Num() != NumRegistered)
+	{
+		for (auto It = RegisteredTeams.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	// sort the actors by grid cell
+	SortScratch.Reset();
+
+	for (int32 Index = 0; Index < RegisteredActors.Num(); ++Index)
+	{
+		SortScratch.Emplace(GetCell(RegisteredActors[Index]->GetActorLocation()), Index);
+	}
+
+	SortScratch.Sort([](const TPair<FIntPoint, int32>& A, const TPair<FIntPoint, int32>& B)
+	{
+		return A.Key.X != B.Key.X ? A.Key.X < B.Key.X : A.Key.Y < B.Key.Y;
+	});
+
+	// rebuild the rows and cell ranges
+	Actors.Reset();
+	Positions.Reset();
+	Teams.Reset();
+	Cells.Reset();
+
+	for (int32 Row = 0; Row < SortScratch.Num(); ++Row)
+	{
+		AActor* Actor = RegisteredActors[SortScratch[Row].Value].Get();
+
+		Actors.Add(Actor);
+		Positions.Add(Actor->GetActorLocation());
+		Teams.Add(RegisteredTeams.FindRef(Actor));
+
+		FCellRange& Range = Cells.FindOrAdd(SortScratch[Row].Key, FCellRange { Row, 0 });
+		++Range.Num;
+	}
+}
+
+TStatId UShooterTeamSpatialHash::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterTeamSpatialHash, STATGROUP_Tickables);
+}
+
+bool UShooterTeamSpatialHash::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterTeamSpatialHash::RegisterActor(AActor* Actor, uint8 TeamByte)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	// update the team if already registered
+	if (uint8* Team = RegisteredTeams.Find(Actor))
+	{
+		*Team = TeamByte;
+		return;
+	}
+
+	RegisteredTeams.Add(Actor, TeamByte);
+	RegisteredActors.Add(Actor);
+}
+
+void UShooterTeamSpatialHash::UnregisterActor(AActor* Actor)
+{
+	if (RegisteredTeams.Remove(Actor) > 0)
+	{
+		RegisteredActors.RemoveSwap(Actor, EAllowShrinking::No);
+
+		// remove it from this frame's rows too, so queries stop returning it right away
+		const int32 Row = Actors.Find(Actor);
+
+		if (Row != INDEX_NONE)
+		{
+			Actors[Row] = nullptr;
+		}
+	}
+}
+
+bool UShooterTeamSpatialHash::GetActorTeam(const AActor* Actor, uint8& OutTeamByte) const
+{
+	if (const uint8* Team = RegisteredTeams.Find(Actor))
+	{
+		OutTeamByte = *Team;
+		return true;
+	}
+
+	return false;
+}
+
+AActor* UShooterTeamSpatialHash::FindNearestEnemy(const FVector& Location, uint8 TeamByte, float Radius) const
+{
+	AActor* Nearest = nullptr;
+	float NearestDistSquared = FMath::Square(Radius);
+
+	ForEachRowInRadius(Location, Radius, [&](int32 Row)
+	{
+		if (Teams[Row] != TeamByte)
+		{
+			const float DistSquared = FVector::DistSquared(Location, Positions[Row]);
+
+			if (DistSquared <= NearestDistSquared)
+			{
+				Nearest = Actors[Row];
+				NearestDistSquared = DistSquared;
+			}
+		}
+	});
+
+	return Nearest;
+}
+
+void UShooterTeamSpatialHash::FindEnemiesInRadius(const FVector& Location, uint8 TeamByte, float Radius, TArray<AActor*>& OutEnemies) const
+{
+	const float RadiusSquared = FMath::Square(Radius);
+
+	ForEachRowInRadius(Location, Radius, [&](int32 Row)
+	{
+		if (Teams[Row] != TeamByte && FVector::DistSquared(Location, Positions[Row]) <= RadiusSquared)
+		{
+			OutEnemies.Add(Actors[Row]);
+		}
+	});
+}
+
+void UShooterTeamSpatialHash::FindEnemiesInCone(const FVector& Location, const FVector& Direction, float ConeHalfAngle, uint8 TeamByte, float Radius, TArray<AActor*>& OutEnemies) const
+{
+	const float RadiusSquared = FMath::Square(Radius);
+	const float MinDot = FMath::Cos(FMath::DegreesToRadians(ConeHalfAngle));
+	const FVector ConeDir = Direction.GetSafeNormal();
+
+	ForEachRowInRadius(Location, Radius, [&](int32 Row)
+	{
+		if (Teams[Row] != TeamByte && FVector::DistSquared(Location, Positions[Row]) <= RadiusSquared)
+		{
+			// is the actor within the cone?
+			if (FVector::DotProduct((Positions[Row] - Location).GetSafeNormal(), ConeDir) >= MinDot)
+			{
+				OutEnemies.Add(Actors[Row]);
+			}
+		}
+	});
+}
+
+FIntPoint UShooterTeamSpatialHash::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+template<typename VisitorType>
+void UShooterTeamSpatialHash::ForEachRowInRadius(const FVector& Location, float Radius, VisitorType&& Visitor) const
+{
+	const FIntPoint MinCell = GetCell(Location - FVector(Radius, Radius, 0.0f));
+	const FIntPoint MaxCell = GetCell(Location + FVector(Radius, Radius, 0.0f));
+
+	// for very large radii it's cheaper to walk the occupied cells than the covered ones
+	if (int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1) > Cells.Num())
+	{
+		for (const TPair<FIntPoint, FCellRange>& Cell : Cells)
+		{
+			if (Cell.Key.X >= MinCell.X && Cell.Key.X <= MaxCell.X && Cell.Key.Y >= MinCell.Y && Cell.Key.Y <= MaxCell.Y)
+			{
+				for (int32 Row = Cell.Value.Start; Row < Cell.Value.Start + Cell.Value.Num; ++Row)
+				{
+					if (Actors[Row])
+					{
+						Visitor(Row);
+					}
+				}
+			}
+		}
+
+		return;
+	}
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			if (const FCellRange* Range = Cells.Find(FIntPoint(X, Y)))
+			{
+				for (int32 Row = Range->Start; Row < Range->Start + Range->Num; ++Row)
+				{
+					// skip actors unregistered since the last rebuild
+					if (Actors[Row])
+					{
+						Visitor(Row);
+					}
+				}
+			}
+		}
+	}
+}
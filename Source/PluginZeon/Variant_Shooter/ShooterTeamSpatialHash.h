@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterTeamSpatialHash.generated.h"
+
+/**
+ *  World subsystem that keeps the living shooter characters and NPCs in a uniform 2D grid
+ *  The grid is rebuilt once per frame from the registered actors' positions
+ *  Proximity queries only visit the grid cells they overlap instead of scanning every actor
+ */
+UCLASS()
+class PLUGINZEON_API UShooterTeamSpatialHash : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Range of sorted member rows that fall in a grid cell */
+	struct FCellRange
+	{
+		int32 Start = 0;
+		int32 Num = 0;
+	};
+
+	/** Registered actors and their teams */
+	TMap<TObjectKey<AActor>, uint8> RegisteredTeams;
+	TArray<TWeakObjectPtr<AActor>> RegisteredActors;
+
+	/** Member rows for the current frame, sorted by grid cell */
+	TArray<AActor*> Actors;
+	TArray<FVector> Positions;
+	TArray<uint8> Teams;
+
+	/** Sorted member ranges by grid cell */
+	TMap<FIntPoint, FCellRange> Cells;
+
+	/** Scratch buffer used to sort the rows by cell */
+	TArray<TPair<FIntPoint, int32>> SortScratch;
+
+protected:
+
+	/** Size of a grid cell side */
+	float CellSize = 1000.0f;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Rebuilds the grid */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only track teams in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Adds a living actor to the grid */
+	void RegisterActor(AActor* Actor, uint8 TeamByte);
+
+	/** Removes an actor from the grid, usually on death */
+	void UnregisterActor(AActor* Actor);
+
+	/** Returns true and sets OutTeamByte if the actor is registered */
+	bool GetActorTeam(const AActor* Actor, uint8& OutTeamByte) const;
+
+	/** Returns the closest actor not on the given team within the radius, or nullptr */
+	AActor* FindNearestEnemy(const FVector& Location, uint8 TeamByte, float Radius) const;
+
+	/** Adds all actors not on the given team within the radius to the out array */
+	void FindEnemiesInRadius(const FVector& Location, uint8 TeamByte, float Radius, TArray<AActor*>& OutEnemies) const;
+
+	/** Adds all actors not on the given team within the radius and the cone half angle around the direction to the out array */
+	void FindEnemiesInCone(const FVector& Location, const FVector& Direction, float ConeHalfAngle, uint8 TeamByte, float Radius, TArray<AActor*>& OutEnemies) const;
+
+protected:
+
+	/** Returns the grid cell for a location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Calls the visitor with each row in the cells overlapping the radius */
+	template<typename VisitorType>
+	void ForEachRowInRadius(const FVector& Location, float Radius, VisitorType&& Visitor) const;
+};
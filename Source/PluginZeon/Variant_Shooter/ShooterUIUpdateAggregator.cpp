@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterUIUpdateAggregator.h"
+#include "ShooterCharacter.h"
+#include "ShooterUI.h"
+#include "Engine/World.h"
+
+void UShooterUIUpdateAggregator::Deinitialize()
+{
+	PendingBulletCounts.Empty();
+	PendingScores.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterUIUpdateAggregator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingBulletCounts.Num() == 0 && PendingScores.Num() == 0)
+	{
+		return;
+	}
+
+	// wait for the flush interval to pass
+	TimeUntilFlush -= DeltaTime;
+
+	if (TimeUntilFlush > 0.0f)
+	{
+		return;
+	}
+
+	FlushUpdates();
+}
+
+TStatId UShooterUIUpdateAggregator::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterUIUpdateAggregator, STATGROUP_Tickables);
+}
+
+bool UShooterUIUpdateAggregator::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterUIUpdateAggregator::SetBulletCount(AShooterCharacter* Character, int32 MagazineSize, int32 Bullets)
+{
+	// the first dirty value opens the flush interval
+	if (PendingBulletCounts.Num() == 0 && PendingScores.Num() == 0)
+	{
+		TimeUntilFlush = FlushInterval;
+	}
+
+	PendingBulletCounts.Add(Character, FIntPoint(MagazineSize, Bullets));
+}
+
+void UShooterUIUpdateAggregator::SetTeamScore(UShooterUI* ShooterUI, uint8 TeamByte, int32 Score)
+{
+	// the first dirty value opens the flush interval
+	if (PendingBulletCounts.Num() == 0 && PendingScores.Num() == 0)
+	{
+		TimeUntilFlush = FlushInterval;
+	}
+
+	PendingScores.Add(TPair<TWeakObjectPtr<UShooterUI>, uint8>(ShooterUI, TeamByte), Score);
+}
+
+void UShooterUIUpdateAggregator::FlushUpdates()
+{
+	// take the batches, since the widget updates may mark new values dirty
+	TMap<TWeakObjectPtr<AShooterCharacter>, FIntPoint> BulletCounts = MoveTemp(PendingBulletCounts);
+	PendingBulletCounts.Reset();
+
+	TMap<TPair<TWeakObjectPtr<UShooterUI>, uint8>, int32> Scores = MoveTemp(PendingScores);
+	PendingScores.Reset();
+
+	// push the latest bullet counts
+	for (const TPair<TWeakObjectPtr<AShooterCharacter>, FIntPoint>& Pair : BulletCounts)
+	{
+		if (AShooterCharacter* Character = Pair.Key.Get())
+		{
+			Character->OnBulletCountUpdated.Broadcast(Pair.Value.X, Pair.Value.Y);
+		}
+	}
+
+	// push the latest scores
+	for (const TPair<TPair<TWeakObjectPtr<UShooterUI>, uint8>, int32>& Pair : Scores)
+	{
+		if (UShooterUI* ShooterUI = Pair.Key.Key.Get())
+		{
+			ShooterUI->BP_UpdateScore(Pair.Key.Value, Pair.Value);
+		}
+	}
+}
@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterUIUpdateAggregator.generated.h"
+
+class AShooterCharacter;
+class UShooterUI;
+
+/**
+ *  World subsystem that coalesces HUD updates
+ *  Gameplay code only marks HUD values dirty, and the latest value of each is pushed to the widgets once per flush
+ *  This keeps Blueprint widget updates off the per shot and per kill paths
+ */
+UCLASS(Config=Game)
+class PLUGINZEON_API UShooterUIUpdateAggregator : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Latest magazine size and bullet count per character, waiting to be pushed */
+	TMap<TWeakObjectPtr<AShooterCharacter>, FIntPoint> PendingBulletCounts;
+
+	/** Latest score per scoreboard widget and team, waiting to be pushed */
+	TMap<TPair<TWeakObjectPtr<UShooterUI>, uint8>, int32> PendingScores;
+
+	/** Time left until the next flush */
+	float TimeUntilFlush = 0.0f;
+
+protected:
+
+	/** Time between HUD flushes. Zero flushes once per frame */
+	UPROPERTY(Config)
+	float FlushInterval = 0.0f;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Pushes the dirty HUD values when the flush interval is over */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only aggregate HUD updates in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Marks a character's bullet counter dirty with its latest values */
+	void SetBulletCount(AShooterCharacter* Character, int32 MagazineSize, int32 Bullets);
+
+	/** Marks a team's score dirty with its latest value */
+	void SetTeamScore(UShooterUI* ShooterUI, uint8 TeamByte, int32 Score);
+
+	/** Pushes all dirty HUD values to the widgets right away */
+	void FlushUpdates();
+};
@@ -11,6 +11,10 @@
 #include "Animation/AnimInstance.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/Pawn.h"
+#include "ShooterProjectilePool.h"
+#include "ShooterProjectileManager.h"
+#include "ShooterNoiseAggregator.h"
+#include "ShooterWeaponFireScheduler.h"
 
 AShooterWeapon::AShooterWeapon()
 {
@@ -50,8 +54,30 @@ void AShooterWeapon::BeginPlay()
 	// fill the first ammo clip
 	CurrentBullets = MagazineSize;
 
+	// owners that never render the first person mesh don't need it to animate, follow them or have a render proxy
+	bUseFirstPersonMesh = WeaponOwner->UsesFirstPersonWeaponMesh();
+
+	if (!bUseFirstPersonMesh)
+	{
+		FirstPersonMesh->SetComponentTickEnabled(false);
+		FirstPersonMesh->SetVisibility(false);
+		FirstPersonMesh->UnregisterComponent();
+	}
+
+	// start at a random point of the aim variance table so weapons don't share a spread pattern
+	AimVarianceIndex = FMath::Rand();
+
 	// attach the meshes to the owner
 	WeaponOwner->AttachWeaponMeshes(this);
+
+	// pre-spawn some projectiles so the first shots don't pay for actor construction
+	if (bUseProjectilePool)
+	{
+		if (UShooterProjectilePool* Pool = GetWorld()->GetSubsystem<UShooterProjectilePool>())
+		{
+			Pool->PrewarmProjectiles(ProjectileClass, PrewarmProjectileCount);
+		}
+	}
 }
 
 void AShooterWeapon::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -60,6 +86,12 @@ void AShooterWeapon::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the refire timer
 	GetWorld()->GetTimerManager().ClearTimer(RefireTimer);
+
+	// cancel any scheduled refire
+	if (UShooterWeaponFireScheduler* FireScheduler = GetWorld()->GetSubsystem<UShooterWeaponFireScheduler>())
+	{
+		FireScheduler->CancelEvent(this);
+	}
 }
 
 void AShooterWeapon::OnOwnerDestroyed(AActor* DestroyedActor)
@@ -89,6 +121,12 @@ void AShooterWeapon::DeactivateWeapon()
 	WeaponOwner->OnWeaponDeactivated(this);
 }
 
+void AShooterWeapon::ResetAmmo()
+{
+	// refill the clip
+	CurrentBullets = MagazineSize;
+}
+
 void AShooterWeapon::StartFiring()
 {
 	// raise the firing flag
@@ -96,9 +134,9 @@ void AShooterWeapon::StartFiring()
 
 	// check how much time has passed since we last shot
 	// this may be under the refire rate if the weapon shoots slow enough and the player is spamming the trigger
-	const float TimeSinceLastShot = GetWorld()->GetTimeSeconds() - TimeOfLastShot;
+	const double TimeSinceLastShot = GetWorld()->GetTimeSeconds() - TimeOfLastShot;
 
-	if (TimeSinceLastShot > RefireRate)
+	if (TimeSinceLastShot >= RefireRate)
 	{
 		// fire the weapon right away
 		Fire();
@@ -108,7 +146,7 @@ void AShooterWeapon::StartFiring()
 		// if we're full auto, schedule the next shot
 		if (bFullAuto)
 		{
-			GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::Fire, TimeSinceLastShot, false);
+			ScheduleFireEvent(EShooterWeaponFireEvent::Refire, TimeOfLastShot + RefireRate);
 		}
 
 	}
@@ -121,35 +159,104 @@ void AShooterWeapon::StopFiring()
 
 	// clear the refire timer
 	GetWorld()->GetTimerManager().ClearTimer(RefireTimer);
+
+	// cancel any scheduled refire
+	if (UShooterWeaponFireScheduler* FireScheduler = GetWorld()->GetSubsystem<UShooterWeaponFireScheduler>())
+	{
+		FireScheduler->CancelEvent(this);
+	}
 }
 
 void AShooterWeapon::Fire()
+{
+	FireAtTime(GetWorld()->GetTimeSeconds());
+}
+
+void AShooterWeapon::FireAtTime(double FirstShotTime, int32 NumShots)
 {
 	// ensure the player still wants to fire. They may have let go of the trigger
-	if (!bIsFiring)
+	if (!bIsFiring || NumShots <= 0)
 	{
 		return;
 	}
 	
-	// fire a projectile at the target
-	FireProjectile(WeaponOwner->GetWeaponTargetLocation());
+	// fire the batch of projectiles at the target
+	FireProjectiles(WeaponOwner->GetWeaponTargetLocation(), FirstShotTime, NumShots);
+
+	// update the time of our last shot. Use the time the shot was due so late shots don't slow down the fire rate
+	const double ShotTime = FirstShotTime + (NumShots - 1) * RefireRate;
+	TimeOfLastShot = ShotTime;
 
-	// update the time of our last shot
-	TimeOfLastShot = GetWorld()->GetTimeSeconds();
+	// make noise so the AI perception system can hear us. Merge it with other nearby shots if possible
+	if (UShooterNoiseAggregator* NoiseAggregator = GetWorld()->GetSubsystem<UShooterNoiseAggregator>())
+	{
+		NoiseAggregator->ReportNoise(PawnOwner, PawnOwner->GetActorLocation(), ShotLoudness, ShotNoiseRange, ShotNoiseTag);
 
-	// make noise so the AI perception system can hear us
-	MakeNoise(ShotLoudness, PawnOwner, PawnOwner->GetActorLocation(), ShotNoiseRange, ShotNoiseTag);
+	} else {
+
+		MakeNoise(ShotLoudness, PawnOwner, PawnOwner->GetActorLocation(), ShotNoiseRange, ShotNoiseTag);
+	}
 
 	// are we full auto?
 	if (bFullAuto)
 	{
 		// schedule the next shot
-		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::Fire, RefireRate, false);
+		ScheduleFireEvent(EShooterWeaponFireEvent::Refire, ShotTime + RefireRate);
 	} else {
 
 		// for semi-auto weapons, schedule the cooldown notification
-		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::FireCooldownExpired, RefireRate, false);
+		ScheduleFireEvent(EShooterWeaponFireEvent::CooldownExpired, ShotTime + RefireRate);
+
+	}
+}
+
+void AShooterWeapon::ScheduleFireEvent(EShooterWeaponFireEvent Event, double EventTime)
+{
+	// batch the event with the other weapons if possible
+	if (UShooterWeaponFireScheduler* FireScheduler = GetWorld()->GetSubsystem<UShooterWeaponFireScheduler>())
+	{
+		FireScheduler->ScheduleEvent(this, Event, EventTime);
+		return;
+	}
+
+	// fall back to our own timer
+	const float Delay = FMath::Max(static_cast<float>(EventTime - GetWorld()->GetTimeSeconds()), UE_KINDA_SMALL_NUMBER);
+
+	if (Event == EShooterWeaponFireEvent::Refire)
+	{
+		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::Fire, Delay, false);
+
+	} else {
+
+		GetWorld()->GetTimerManager().SetTimer(RefireTimer, this, &AShooterWeapon::FireCooldownExpired, Delay, false);
+	}
+}
+
+void AShooterWeapon::HandleFireEvent(EShooterWeaponFireEvent Event, double EventTime)
+{
+	if (Event == EShooterWeaponFireEvent::Refire)
+	{
+		// work out how many shots are owed since the event came due
+		int32 NumShots = 1;
+
+		if (RefireRate > 0.0f)
+		{
+			NumShots += FMath::FloorToInt32((GetWorld()->GetTimeSeconds() - EventTime) / RefireRate);
+		}
+
+		// drop the oldest owed shots over the batch limit so a long hitch doesn't turn into a burst
+		if (NumShots > MaxShotsPerFrame)
+		{
+			EventTime += (NumShots - MaxShotsPerFrame) * RefireRate;
+			NumShots = MaxShotsPerFrame;
+		}
 
+		// fire all owed shots together
+		FireAtTime(EventTime, NumShots);
+
+	} else {
+
+		FireCooldownExpired();
 	}
 }
 
@@ -159,52 +266,158 @@ void AShooterWeapon::FireCooldownExpired()
 	WeaponOwner->OnSemiWeaponRefire();
 }
 
-void AShooterWeapon::FireProjectile(const FVector& TargetLocation)
+void AShooterWeapon::FireProjectiles(const FVector& TargetLocation, double FirstShotTime, int32 NumShots)
 {
-	// get the projectile transform
-	FTransform ProjectileTransform = CalculateProjectileSpawnTransform(TargetLocation);
-	
-	// spawn the projectile
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-	SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::OverrideRootScale;
-	SpawnParams.Owner = GetOwner();
-	SpawnParams.Instigator = PawnOwner;
+	// build the spawn transforms for the whole batch
+	TArray<FTransform, TInlineAllocator<8>> ShotTransforms;
+	CalculateProjectileSpawnTransforms(TargetLocation, FirstShotTime, NumShots, ShotTransforms);
 
-	AShooterProjectile* Projectile = GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, ProjectileTransform, SpawnParams);
+	for (const FTransform& ShotTransform : ShotTransforms)
+	{
+		SpawnProjectile(ShotTransform);
+	}
 
 	// play the firing montage
 	WeaponOwner->PlayFiringMontage(FiringMontage);
 
-	// add recoil
-	WeaponOwner->AddWeaponRecoil(FiringRecoil);
+	// add recoil for the whole batch
+	WeaponOwner->AddWeaponRecoil(FiringRecoil * NumShots);
 
 	// consume bullets
-	--CurrentBullets;
+	CurrentBullets -= NumShots;
 
-	// if the clip is depleted, reload it
-	if (CurrentBullets <= 0)
+	// if the clip is depleted, reload it. Shots past the end of the clip come out of the new one
+	if (CurrentBullets <= 0 && MagazineSize > 0)
 	{
-		CurrentBullets = MagazineSize;
+		CurrentBullets = MagazineSize + (CurrentBullets % MagazineSize);
 	}
 
 	// update the weapon HUD
 	WeaponOwner->UpdateWeaponHUD(CurrentBullets, MagazineSize);
 }
 
-FTransform AShooterWeapon::CalculateProjectileSpawnTransform(const FVector& TargetLocation) const
+void AShooterWeapon::SpawnProjectile(const FTransform& ProjectileTransform)
 {
+	UShooterProjectileManager* ProjectileManager = FireMode != EShooterFireMode::Projectile ? GetWorld()->GetSubsystem<UShooterProjectileManager>() : nullptr;
+	UShooterProjectilePool* Pool = bUseProjectilePool ? GetWorld()->GetSubsystem<UShooterProjectilePool>() : nullptr;
+
+	if (ProjectileManager && FireMode == EShooterFireMode::Hitscan)
+	{
+		// queue an instant shot
+		ProjectileManager->FireHitscanShot(ProjectileClass, ProjectileTransform, HitscanRange, GetOwner(), PawnOwner);
+
+	} else if (ProjectileManager) {
+
+		// add a simulated projectile
+		ProjectileManager->SpawnProjectile(ProjectileClass, ProjectileTransform, GetOwner(), PawnOwner);
+
+	} else if (Pool) {
+
+		// reuse a pooled projectile
+		Pool->AcquireProjectile(ProjectileClass, ProjectileTransform, GetOwner(), PawnOwner);
+
+	} else {
+
+		// spawn the projectile
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::OverrideRootScale;
+		SpawnParams.Owner = GetOwner();
+		SpawnParams.Instigator = PawnOwner;
+
+		GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, ProjectileTransform, SpawnParams);
+	}
+}
+
+void AShooterWeapon::CalculateProjectileSpawnTransforms(const FVector& TargetLocation, double FirstShotTime, int32 NumShots, TArray<FTransform, TInlineAllocator<8>>& OutTransforms)
+{
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
 	// find the muzzle location
-	const FVector MuzzleLoc = FirstPersonMesh->GetSocketLocation(MuzzleSocketName);
+	const FVector MuzzleLoc = GetMuzzleLocation();
 
-	// calculate the spawn location ahead of the muzzle
-	const FVector SpawnLoc = MuzzleLoc + ((TargetLocation - MuzzleLoc).GetSafeNormal() * MuzzleOffset);
+	// if we weren't firing during the last refire window there's nothing to interpolate from
+	if (LastBatchTime < FirstShotTime - RefireRate)
+	{
+		LastBatchMuzzleLocation = MuzzleLoc;
+		LastBatchTime = CurrentTime;
+	}
+
+	const double BatchDuration = CurrentTime - LastBatchTime;
+	const TArray<FVector>& VarianceTable = GetAimVarianceTable();
+	const uint32 VarianceMask = VarianceTable.Num() - 1;
+
+	OutTransforms.SetNumUninitialized(NumShots);
+
+	for (int32 ShotIndex = 0; ShotIndex < NumShots; ++ShotIndex)
+	{
+		// place late shots along the path the muzzle took since the last batch
+		const double ShotTime = FirstShotTime + ShotIndex * RefireRate;
+		const double Alpha = BatchDuration > 0.0 ? FMath::Clamp((ShotTime - LastBatchTime) / BatchDuration, 0.0, 1.0) : 1.0;
+		const FVector ShotMuzzleLoc = FMath::Lerp(LastBatchMuzzleLocation, MuzzleLoc, Alpha);
+
+		// calculate the spawn location ahead of the muzzle
+		const FVector SpawnLoc = ShotMuzzleLoc + ((TargetLocation - ShotMuzzleLoc).GetSafeNormal() * MuzzleOffset);
+
+		// aim at the target with the next variance offset from the table
+		const FVector AimLoc = TargetLocation + (VarianceTable[(AimVarianceIndex + ShotIndex) & VarianceMask] * AimVariance);
+
+		OutTransforms[ShotIndex] = FTransform((AimLoc - SpawnLoc).ToOrientationQuat(), SpawnLoc, FVector::OneVector);
+	}
+
+	AimVarianceIndex += NumShots;
+
+	LastBatchMuzzleLocation = MuzzleLoc;
+	LastBatchTime = CurrentTime;
+}
+
+FVector AShooterWeapon::GetMuzzleLocation()
+{
+	// socket queries may force a bone transform update, so only ask once per frame
+	if (CachedMuzzleFrame != GFrameCounter)
+	{
+		CachedMuzzleLocation = GetMuzzleMesh()->GetSocketLocation(MuzzleSocketName);
+		CachedMuzzleFrame = GFrameCounter;
+	}
+
+	return CachedMuzzleLocation;
+}
+
+USkeletalMeshComponent* AShooterWeapon::GetMuzzleMesh() const
+{
+	// owners without a first person view shoot from the third person mesh
+	return bUseFirstPersonMesh ? FirstPersonMesh : ThirdPersonMesh;
+}
+
+const TArray<FVector>& AShooterWeapon::GetAimVarianceTable()
+{
+	static const TArray<FVector> VarianceTable = []()
+	{
+		// table size must be a power of two so indices can wrap with a mask
+		constexpr int32 TableSize = 64;
+
+		// odd stride so consecutive shots jump across the sphere instead of walking down it
+		constexpr int32 ScrambleStride = 37;
+
+		const double GoldenAngle = UE_DOUBLE_PI * (3.0 - FMath::Sqrt(5.0));
+
+		TArray<FVector> Table;
+		Table.SetNumUninitialized(TableSize);
+
+		// spherical Fibonacci points are evenly spread over the sphere
+		for (int32 Index = 0; Index < TableSize; ++Index)
+		{
+			const double Z = 1.0 - (2.0 * Index + 1.0) / TableSize;
+			const double Radius = FMath::Sqrt(1.0 - Z * Z);
+			const double Phi = GoldenAngle * Index;
+
+			Table[(Index * ScrambleStride) & (TableSize - 1)] = FVector(Radius * FMath::Cos(Phi), Radius * FMath::Sin(Phi), Z);
+		}
 
-	// find the aim rotation vector while applying some variance to the target 
-	const FRotator AimRot = UKismetMathLibrary::FindLookAtRotation(SpawnLoc, TargetLocation + (UKismetMathLibrary::RandomUnitVector() * AimVariance));
+		return Table;
+	}();
 
-	// return the built transform
-	return FTransform(AimRot, SpawnLoc, FVector::OneVector);
+	return VarianceTable;
 }
 
 const TSubclassOf<UAnimInstance>& AShooterWeapon::GetFirstPersonAnimInstanceClass() const
@@ -6,6 +6,7 @@
 #include "GameFramework/Actor.h"
 #include "ShooterWeaponHolder.h"
 #include "Animation/AnimInstance.h"
+#include "ShooterWeaponFireScheduler.h"
 #include "ShooterWeapon.generated.h"
 
 class IShooterWeaponHolder;
@@ -14,6 +15,22 @@ class USkeletalMeshComponent;
 class UAnimMontage;
 class UAnimInstance;
 
+/**
+ *  How a weapon delivers its shots
+ */
+UENUM(BlueprintType)
+enum class EShooterFireMode : uint8
+{
+	/** Each shot is a projectile actor */
+	Projectile,
+
+	/** Each shot is simulated as data by the projectile manager. Actors are only brought in at the impact point */
+	SimulatedProjectile,
+
+	/** Each shot hits instantly along an async line trace. Actors are only brought in at the impact point */
+	Hitscan
+};
+
 /**
  *  Base class for a simple first person shooter weapon
  *  Provides both first person and third person perspective meshes
@@ -42,6 +59,22 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Ammo")
 	TSubclassOf<AShooterProjectile> ProjectileClass;
 
+	/** How shots from this weapon are delivered */
+	UPROPERTY(EditAnywhere, Category="Ammo")
+	EShooterFireMode FireMode = EShooterFireMode::Projectile;
+
+	/** Max distance of hitscan shots */
+	UPROPERTY(EditAnywhere, Category="Ammo", meta = (EditCondition = "FireMode == EShooterFireMode::Hitscan", ClampMin = 0, Units = "cm"))
+	float HitscanRange = 10000.0f;
+
+	/** If true, projectiles are recycled through the world projectile pool instead of spawned and destroyed */
+	UPROPERTY(EditAnywhere, Category="Ammo")
+	bool bUseProjectilePool = true;
+
+	/** Number of projectiles to pre-spawn in the pool when this weapon begins play */
+	UPROPERTY(EditAnywhere, Category="Ammo", meta = (EditCondition = "bUseProjectilePool", ClampMin = 0))
+	int32 PrewarmProjectileCount = 10;
+
 	/** Number of bullets in a magazine */
 	UPROPERTY(EditAnywhere, Category="Ammo")
 	int32 MagazineSize = 10;
@@ -85,13 +118,33 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Refire")
 	float RefireRate = 0.5f;
 
+	/** Max number of owed full auto shots fired in a single batch. Shots owed beyond this are dropped */
+	UPROPERTY(EditAnywhere, Category="Refire", meta = (ClampMin = 1))
+	int32 MaxShotsPerFrame = 8;
+
 	/** Game time of last shot fired, used to enforce refire rate on semi auto */
-	float TimeOfLastShot = 0.0f;
+	double TimeOfLastShot = 0.0;
+
+	/** Muzzle location and game time of the last shot batch, used to interpolate the muzzle for late shots */
+	FVector LastBatchMuzzleLocation = FVector::ZeroVector;
+	double LastBatchTime = -1.0;
+
+	/** Muzzle socket location cached for the current frame */
+	FVector CachedMuzzleLocation = FVector::ZeroVector;
+
+	/** Frame the muzzle location was cached on */
+	uint64 CachedMuzzleFrame = MAX_uint64;
+
+	/** Next entry of the aim variance table to use */
+	uint32 AimVarianceIndex = 0;
+
+	/** If false, the owner never renders the first person mesh, so it's disabled and shots come from the third person muzzle */
+	bool bUseFirstPersonMesh = true;
 
 	/** If true, the weapon is currently firing */
 	bool bIsFiring = false;
 
-	/** Timer to handle full auto refiring */
+	/** Timer to handle refiring when the fire scheduler isn't available */
 	FTimerHandle RefireTimer;
 
 	/** Cast pawn pointer to the owner for AI perception system interactions */
@@ -142,19 +195,43 @@ public:
 	/** Stop firing this weapon */
 	void StopFiring();
 
+	/** Refills the magazine, used when the owner respawns */
+	void ResetAmmo();
+
+	/** Handles a refire or cooldown event that was due at the given game time. Called by the fire scheduler */
+	void HandleFireEvent(EShooterWeaponFireEvent Event, double EventTime);
+
 protected:
 
 	/** Fire the weapon */
 	virtual void Fire();
 
+	/** Fire a batch of shots, the first of which was due at the given game time */
+	void FireAtTime(double FirstShotTime, int32 NumShots = 1);
+
+	/** Schedules a refire or cooldown event at the given game time */
+	void ScheduleFireEvent(EShooterWeaponFireEvent Event, double EventTime);
+
 	/** Called when the refire rate time has passed while shooting semi auto weapons */
 	void FireCooldownExpired();
 
-	/** Fire a projectile towards the target location */
-	virtual void FireProjectile(const FVector& TargetLocation);
+	/** Fire a batch of projectiles towards the target location, spaced by the refire rate from the first shot time */
+	virtual void FireProjectiles(const FVector& TargetLocation, double FirstShotTime, int32 NumShots);
+
+	/** Delivers a single shot with the given spawn transform according to the fire mode */
+	void SpawnProjectile(const FTransform& ProjectileTransform);
+
+	/** Calculates the spawn transforms for a batch of projectiles, interpolating the muzzle for late shots */
+	void CalculateProjectileSpawnTransforms(const FVector& TargetLocation, double FirstShotTime, int32 NumShots, TArray<FTransform, TInlineAllocator<8>>& OutTransforms);
+
+	/** Returns the muzzle socket location, fetching it at most once per frame */
+	FVector GetMuzzleLocation();
+
+	/** Returns the mesh to take the muzzle socket from */
+	USkeletalMeshComponent* GetMuzzleMesh() const;
 
-	/** Calculates the spawn transform for projectiles shot by this weapon */
-	FTransform CalculateProjectileSpawnTransform(const FVector& TargetLocation) const;
+	/** Returns a table of unit vectors evenly spread over the sphere, shared by all weapons for aim variance */
+	static const TArray<FVector>& GetAimVarianceTable();
 
 public:
 
@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterWeaponFireScheduler.h"
+#include "ShooterWeapon.h"
+#include "Engine/World.h"
+
+void UShooterWeaponFireScheduler::Deinitialize()
+{
+	Weapons.Empty();
+	EventTimes.Empty();
+	Events.Empty();
+	RowIndices.Empty();
+	DueEvents.Empty();
+
+	Super::Deinitialize();
+}
+
+void UShooterWeaponFireScheduler::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// handling an event usually schedules the weapon's next one,
+	// so keep going while events come due to emit multiple shots per frame
+	for (int32 Pass = 0; Pass < MaxEventsPerWeaponPerFrame && Weapons.Num() > 0; ++Pass)
+	{
+		// take the due rows out, back to front so the swaps don't skip any
+		DueEvents.Reset();
+
+		for (int32 Index = Weapons.Num() - 1; Index >= 0; --Index)
+		{
+			if (EventTimes[Index] <= CurrentTime)
+			{
+				DueEvents.Add({ Weapons[Index], EventTimes[Index], Events[Index] });
+				RemoveRowAtSwap(Index);
+			}
+		}
+
+		if (DueEvents.Num() == 0)
+		{
+			break;
+		}
+
+		// let each weapon handle its event. This may schedule new rows
+		for (const FDueFireEvent& DueEvent : DueEvents)
+		{
+			if (AShooterWeapon* Weapon = DueEvent.Weapon.Get())
+			{
+				Weapon->HandleFireEvent(DueEvent.Event, DueEvent.EventTime);
+			}
+		}
+	}
+}
+
+TStatId UShooterWeaponFireScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterWeaponFireScheduler, STATGROUP_Tickables);
+}
+
+bool UShooterWeaponFireScheduler::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterWeaponFireScheduler::ScheduleEvent(AShooterWeapon* Weapon, EShooterWeaponFireEvent Event, double EventTime)
+{
+	if (!IsValid(Weapon))
+	{
+		return;
+	}
+
+	// reuse the weapon's row if it already has one
+	if (const int32* Index = RowIndices.Find(Weapon))
+	{
+		EventTimes[*Index] = EventTime;
+		Events[*Index] = Event;
+		return;
+	}
+
+	RowIndices.Add(Weapon, Weapons.Num());
+	Weapons.Add(Weapon);
+	EventTimes.Add(EventTime);
+	Events.Add(Event);
+}
+
+void UShooterWeaponFireScheduler::CancelEvent(AShooterWeapon* Weapon)
+{
+	if (const int32* Index = RowIndices.Find(Weapon))
+	{
+		RemoveRowAtSwap(*Index);
+	}
+}
+
+void UShooterWeaponFireScheduler::RemoveRowAtSwap(int32 Index)
+{
+	RowIndices.Remove(Weapons[Index]);
+
+	const int32 LastIndex = Weapons.Num() - 1;
+
+	// point the lookup of the row being moved to its new index
+	if (Index != LastIndex)
+	{
+		RowIndices.Add(Weapons[LastIndex], Index);
+	}
+
+	Weapons.RemoveAtSwap(Index, EAllowShrinking::No);
+	EventTimes.RemoveAtSwap(Index, EAllowShrinking::No);
+	Events.RemoveAtSwap(Index, EAllowShrinking::No);
+}
@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterWeaponFireScheduler.generated.h"
+
+class AShooterWeapon;
+
+/**
+ *  Timed weapon events handled by the fire scheduler
+ */
+enum class EShooterWeaponFireEvent : uint8
+{
+	/** Fire the next full auto shot */
+	Refire,
+
+	/** Notify the owner that a semi auto weapon can shoot again */
+	CooldownExpired
+};
+
+/**
+ *  World subsystem that drives weapon refire instead of one timer per weapon
+ *  Each weapon with a pending event is a row in packed arrays, and all due events are handled in a single pass per frame
+ *  Events are scheduled at absolute game times, so a weapon can shoot several times in one frame to keep its fire rate
+ */
+UCLASS(Config=Game)
+class PLUGINZEON_API UShooterWeaponFireScheduler : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A due event copied out of the rows before it's handled */
+	struct FDueFireEvent
+	{
+		TWeakObjectPtr<AShooterWeapon> Weapon;
+		double EventTime;
+		EShooterWeaponFireEvent Event;
+	};
+
+	/** Scheduled event rows. All arrays share the same index */
+	TArray<TWeakObjectPtr<AShooterWeapon>> Weapons;
+	TArray<double> EventTimes;
+	TArray<EShooterWeaponFireEvent> Events;
+
+	/** Lookup from weapon to its row */
+	TMap<TWeakObjectPtr<AShooterWeapon>, int32> RowIndices;
+
+	/** Per frame scratch list of due events */
+	TArray<FDueFireEvent> DueEvents;
+
+protected:
+
+	/** Max number of events a single weapon can handle in one frame */
+	UPROPERTY(Config)
+	int32 MaxEventsPerWeaponPerFrame = 16;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Handles all due weapon events */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable object */
+	virtual TStatId GetStatId() const override;
+
+protected:
+
+	/** Only schedule weapon events in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+public:
+
+	/** Schedules a weapon event at the given game time, replacing any event the weapon already had */
+	void ScheduleEvent(AShooterWeapon* Weapon, EShooterWeaponFireEvent Event, double EventTime);
+
+	/** Cancels the weapon's pending event */
+	void CancelEvent(AShooterWeapon* Weapon);
+
+	/** Returns the number of weapons with a pending event */
+	UFUNCTION(BlueprintPure, Category="Weapon Fire Scheduler")
+	int32 GetNumScheduledWeapons() const { return Weapons.Num(); }
+
+protected:
+
+	/** Removes a row by swapping the last row into its place */
+	void RemoveRowAtSwap(int32 Index);
+};
@@ -41,8 +41,8 @@ public:
 	/** Calculates and returns the aim location for the weapon */
 	virtual FVector GetWeaponTargetLocation() = 0;
 
-	/** Gives a weapon of this class to the owner */
-	virtual void AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass) = 0;
+	/** Gives a weapon of this class to the owner. Returns false if the owner can't take it, e.g. because its inventory is full */
+	virtual bool AddWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass) = 0;
 
 	/** Activates the passed weapon */
 	virtual void OnWeaponActivated(AShooterWeapon* Weapon) = 0;
@@ -52,4 +52,7 @@ public:
 
 	/** Notifies the owner that the weapon cooldown has expired and it's ready to shoot again */
 	virtual void OnSemiWeaponRefire() = 0;
+
+	/** Returns true if the owner ever renders the first person weapon mesh */
+	virtual bool UsesFirstPersonWeaponMesh() const = 0;
 };
@@ -0,0 +1,140 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/ShooterWeaponInventoryComponent.h"
+#include "ShooterWeapon.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+UShooterWeaponInventoryComponent::UShooterWeaponInventoryComponent()
+{
+	// the inventory only reacts to pickups and inputs
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UShooterWeaponInventoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// the inventory never grows past its capacity
+	Weapons.Reserve(MaxWeapons);
+	SlotsByClass.Reserve(MaxWeapons);
+
+	// spawn the hidden weapons ahead of time
+	for (const TSubclassOf<AShooterWeapon>& WeaponClass : PrespawnedWeaponClasses)
+	{
+		if (!WeaponClass || ParkedWeapons.Contains(WeaponClass.Get()))
+		{
+			continue;
+		}
+
+		if (AShooterWeapon* Weapon = SpawnWeapon(WeaponClass))
+		{
+			// park the weapon until it's picked up
+			Weapon->DeactivateWeapon();
+			ParkedWeapons.Add(WeaponClass.Get(), Weapon);
+		}
+	}
+}
+
+AShooterWeapon* UShooterWeaponInventoryComponent::AddWeapon(const TSubclassOf<AShooterWeapon>& WeaponClass)
+{
+	if (!WeaponClass)
+	{
+		return nullptr;
+	}
+
+	// do we already own this weapon?
+	if (AShooterWeapon* OwnedWeapon = FindWeaponOfClass(WeaponClass))
+	{
+		return OwnedWeapon;
+	}
+
+	// is there room for it?
+	if (Weapons.Num() >= MaxWeapons)
+	{
+		return nullptr;
+	}
+
+	AShooterWeapon* Weapon = nullptr;
+
+	// reuse a parked weapon if we have one
+	TObjectPtr<AShooterWeapon> ParkedWeapon;
+
+	if (ParkedWeapons.RemoveAndCopyValue(WeaponClass.Get(), ParkedWeapon) && IsValid(ParkedWeapon))
+	{
+		Weapon = ParkedWeapon;
+
+	} else {
+
+		Weapon = SpawnWeapon(WeaponClass);
+	}
+
+	if (Weapon)
+	{
+		// add the weapon to the next free slot
+		SlotsByClass.Add(WeaponClass.Get(), Weapons.Add(Weapon));
+	}
+
+	return Weapon;
+}
+
+void UShooterWeaponInventoryComponent::EquipWeaponAtIndex(int32 Index)
+{
+	if (!Weapons.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	// deactivate the old weapon
+	if (AShooterWeapon* CurrentWeapon = GetCurrentWeapon())
+	{
+		CurrentWeapon->DeactivateWeapon();
+	}
+
+	// activate the new weapon
+	CurrentIndex = Index;
+	Weapons[CurrentIndex]->ActivateWeapon();
+}
+
+void UShooterWeaponInventoryComponent::EquipNextWeapon()
+{
+	// ensure we have at least two weapons to switch between
+	if (Weapons.Num() > 1)
+	{
+		EquipWeaponAtIndex((CurrentIndex + 1) % Weapons.Num());
+	}
+}
+
+AShooterWeapon* UShooterWeaponInventoryComponent::FindWeaponOfClass(const TSubclassOf<AShooterWeapon>& WeaponClass) const
+{
+	// try the exact class first
+	if (const int32* Slot = SlotsByClass.Find(WeaponClass.Get()))
+	{
+		return Weapons[*Slot].Get();
+	}
+
+	// fall back to subclasses of the requested class
+	for (AShooterWeapon* Weapon : Weapons)
+	{
+		if (Weapon && Weapon->IsA(WeaponClass))
+		{
+			return Weapon;
+		}
+	}
+
+	return nullptr;
+}
+
+AShooterWeapon* UShooterWeaponInventoryComponent::SpawnWeapon(const TSubclassOf<AShooterWeapon>& WeaponClass) const
+{
+	AActor* OwnerActor = GetOwner();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = OwnerActor;
+	SpawnParams.Instigator = Cast<APawn>(OwnerActor);
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.TransformScaleMethod = ESpawnActorScaleMethod::MultiplyWithRoot;
+
+	return GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, OwnerActor->GetActorTransform(), SpawnParams);
+}
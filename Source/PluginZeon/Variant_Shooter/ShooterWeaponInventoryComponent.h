@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ShooterWeaponInventoryComponent.generated.h"
+
+class AShooterWeapon;
+
+/**
+ *  Fixed capacity weapon inventory for shooter characters and NPCs
+ *  Weapons live in indexed slots with a class to slot lookup, so switching and pickup checks don't search the inventory
+ *  Weapon actors can be pre-spawned hidden so picking up a weapon reuses one instead of spawning it
+ */
+UCLASS(ClassGroup=(Shooter), meta=(BlueprintSpawnableComponent))
+class PLUGINZEON_API UShooterWeaponInventoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	/** Owned weapons by slot */
+	UPROPERTY()
+	TArray<TObjectPtr<AShooterWeapon>> Weapons;
+
+	/** Lookup from weapon class to its slot */
+	TMap<UClass*, int32> SlotsByClass;
+
+	/** Hidden weapons spawned ahead of time, waiting to be picked up */
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, TObjectPtr<AShooterWeapon>> ParkedWeapons;
+
+	/** Slot of the equipped weapon */
+	int32 CurrentIndex = INDEX_NONE;
+
+protected:
+
+	/** Max number of weapons this inventory can hold */
+	UPROPERTY(EditAnywhere, Category="Inventory", meta = (ClampMin = 1))
+	int32 MaxWeapons = 4;
+
+	/** Weapon classes to spawn hidden at begin play, so picking them up later doesn't spawn an actor */
+	UPROPERTY(EditAnywhere, Category="Inventory")
+	TArray<TSubclassOf<AShooterWeapon>> PrespawnedWeaponClasses;
+
+public:
+
+	/** Constructor */
+	UShooterWeaponInventoryComponent();
+
+protected:
+
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
+public:
+
+	/** Adds a weapon of the given class to a free slot and returns it. Returns the owned weapon if there's one already, or null if the inventory is full */
+	AShooterWeapon* AddWeapon(const TSubclassOf<AShooterWeapon>& WeaponClass);
+
+	/** Deactivates the current weapon and activates the one in the given slot */
+	void EquipWeaponAtIndex(int32 Index);
+
+	/** Equips the weapon in the next slot, wrapping around to the first one */
+	void EquipNextWeapon();
+
+	/** Returns the owned weapon of the given class or a subclass of it, if any. Exact class matches are found without a scan */
+	AShooterWeapon* FindWeaponOfClass(const TSubclassOf<AShooterWeapon>& WeaponClass) const;
+
+	/** Returns the equipped weapon, if any */
+	UFUNCTION(BlueprintPure, Category="Inventory")
+	AShooterWeapon* GetCurrentWeapon() const { return Weapons.IsValidIndex(CurrentIndex) ? Weapons[CurrentIndex].Get() : nullptr; }
+
+	/** Returns the slot of the equipped weapon */
+	UFUNCTION(BlueprintPure, Category="Inventory")
+	int32 GetCurrentIndex() const { return CurrentIndex; }
+
+	/** Returns the number of owned weapons */
+	UFUNCTION(BlueprintPure, Category="Inventory")
+	int32 GetNumWeapons() const { return Weapons.Num(); }
+
+protected:
+
+	/** Spawns a weapon of the given class owned by the inventory's owner */
+	AShooterWeapon* SpawnWeapon(const TSubclassOf<AShooterWeapon>& WeaponClass) const;
+};